@@ -0,0 +1,46 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Measures throwing an exception through a number of frames that do not
+// handle it, some of which have unrelated catch blocks, and catching it.
+
+import "BenchmarkBase.dart";
+
+const int DEPTH = 50;
+const int THROWS = 1000;
+
+main() {
+  new ThrowCatch().report();
+}
+
+class ThrowCatch extends BenchmarkBase {
+  ThrowCatch() : super("ThrowCatch");
+
+  void exercise() => run();
+
+  void run() {
+    int caught = 0;
+    for (int i = 0; i < THROWS; i++) {
+      try {
+        recurse(DEPTH);
+      } on int catch (e) {
+        caught += e;
+      }
+    }
+    Expect.equals(THROWS * DEPTH, caught);
+  }
+
+  int recurse(int n) {
+    if (n == 0) throw DEPTH;
+    if (n.isEven) return recurse(n - 1) + 1;
+    // Frames with a catch block that does not cover the throw site are on
+    // the stack as well.
+    try {
+      n = n - 1;
+    } on String catch (e) {
+      return -1;
+    }
+    return recurse(n) + 1;
+  }
+}
@@ -0,0 +1,37 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Measures how fast short-lived fibers can be created, run and exited.
+
+import 'dart:dartino';
+
+import '../BenchmarkBase.dart';
+
+const int FIBERS = 1000;
+
+void main() {
+  new FiberCreateBenchmark().report();
+}
+
+class FiberCreateBenchmark extends BenchmarkBase {
+  int count = 0;
+
+  FiberCreateBenchmark() : super("FiberCreate");
+
+  void exercise() => run();
+
+  void run() {
+    count = 0;
+    for (int i = 0; i < FIBERS; i++) {
+      Fiber.fork(increment);
+      // Let the new fiber run to completion and exit.
+      Fiber.yield();
+    }
+    Expect.equals(FIBERS, count);
+  }
+
+  void increment() {
+    count++;
+  }
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Measures the cost of switching between a set of long-lived fibers.
+
+import 'dart:dartino';
+
+import '../BenchmarkBase.dart';
+
+const int FIBERS = 10;
+const int SWITCHES = 1000;
+
+void main() {
+  new FiberSwitchBenchmark().report();
+}
+
+class FiberSwitchBenchmark extends BenchmarkBase {
+  List<Fiber> fibers;
+  bool done = false;
+
+  FiberSwitchBenchmark() : super("FiberSwitch");
+
+  void setup() {
+    fibers = new List<Fiber>(FIBERS);
+    for (int i = 0; i < FIBERS; i++) {
+      fibers[i] = Fiber.fork(spin);
+    }
+  }
+
+  void exercise() => run();
+
+  // Every yield switches to each of the other fibers once.
+  void run() {
+    for (int i = 0; i < SWITCHES; i++) Fiber.yield();
+  }
+
+  void teardown() {
+    done = true;
+    for (Fiber fiber in fibers) fiber.join();
+  }
+
+  void spin() {
+    while (!done) Fiber.yield();
+  }
+}
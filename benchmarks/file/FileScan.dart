@@ -0,0 +1,66 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Measures counting the lines of a large file, the pattern of scanning logs
+// and configuration files, by reading it in chunks and through a mapping.
+
+import 'dart:typed_data';
+
+import 'package:file/file.dart';
+
+const int LINES = 200000;
+const int LINE_LENGTH = 80;
+const int LINES_PER_BLOCK = 1000;
+const int CHUNK_SIZE = 64 * 1024;
+const int NEWLINE = 10;
+
+int countLines(Uint8List bytes) {
+  int lines = 0;
+  for (int i = 0; i < bytes.length; i++) {
+    if (bytes[i] == NEWLINE) lines++;
+  }
+  return lines;
+}
+
+int scanByReading(File file) {
+  file.position = 0;
+  int lines = 0;
+  while (true) {
+    ByteBuffer chunk = file.read(CHUNK_SIZE);
+    if (chunk.lengthInBytes == 0) return lines;
+    lines += countLines(new Uint8List.view(chunk));
+  }
+}
+
+int scanByMapping(File file) {
+  MappedFile mapped = file.map();
+  int lines = countLines(mapped.asUint8List());
+  mapped.close();
+  return lines;
+}
+
+void report(String name, File file, int scan(File file)) {
+  Stopwatch watch = new Stopwatch()..start();
+  int lines = scan(file);
+  int micros = watch.elapsedMicroseconds;
+  if (lines != LINES) throw "Wrong line count: $lines";
+  print("$name(RunTime): $micros us.");
+}
+
+void main() {
+  File file = new File.temporary("/tmp/file_scan_benchmark");
+  Uint8List block = new Uint8List(LINES_PER_BLOCK * LINE_LENGTH);
+  for (int i = LINE_LENGTH - 1; i < block.length; i += LINE_LENGTH) {
+    block[i] = NEWLINE;
+  }
+  for (int i = 0; i < LINES ~/ LINES_PER_BLOCK; i++) file.write(block.buffer);
+
+  try {
+    report("FileScanRead", file, scanByReading);
+    report("FileScanMapped", file, scanByMapping);
+  } finally {
+    file.close();
+    File.delete(file.path);
+  }
+}
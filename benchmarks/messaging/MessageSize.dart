@@ -0,0 +1,77 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+
+import '../BenchmarkBase.dart';
+
+// Number of entries in each message.
+const int MESSAGE_SIZE = 100;
+const int MESSAGES = 100;
+
+void main() {
+  new SendCopyBenchmark().report();
+  new SendConvertedBenchmark().report();
+}
+
+List buildMessage() {
+  var message = new List(MESSAGE_SIZE);
+  for (int i = 0; i < MESSAGE_SIZE; i++) message[i] = [i, "entry"];
+  return message;
+}
+
+// Immutable equivalent of a list of pairs, as built by programs that have to
+// convert their data before it can be sent.
+class Entry {
+  final int index;
+  final String name;
+  final Entry next;
+  const Entry(this.index, this.name, this.next);
+}
+
+Entry convert(List message) {
+  Entry result = null;
+  for (int i = message.length - 1; i >= 0; i--) {
+    List pair = message[i];
+    result = new Entry(pair[0], pair[1], result);
+  }
+  return result;
+}
+
+abstract class MessageSizeBenchmark extends BenchmarkBase {
+  Channel input;
+  Port output;
+  List message;
+
+  MessageSizeBenchmark(String name) : super(name);
+
+  void sendMessage();
+
+  void setup() {
+    input = new Channel();
+    output = new Port(input);
+    message = buildMessage();
+  }
+
+  void exercise() => run();
+
+  void run() {
+    for (int i = 0; i < MESSAGES; i++) {
+      sendMessage();
+      input.receive();
+    }
+  }
+}
+
+class SendCopyBenchmark extends MessageSizeBenchmark {
+  SendCopyBenchmark() : super("MessageSizeSendCopy");
+
+  void sendMessage() => output.sendCopy(message);
+}
+
+class SendConvertedBenchmark extends MessageSizeBenchmark {
+  SendConvertedBenchmark() : super("MessageSizeSendConverted");
+
+  void sendMessage() => output.send(convert(message));
+}
@@ -0,0 +1,21 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+
+import 'ProgramChannelInterProgram.dart' show REQUESTS, REPLIES;
+
+// The other program of ProgramChannelInterProgram.dart. Echoes messages
+// until it receives an empty one.
+void main() {
+  var requests = new ProgramChannel.open(REQUESTS);
+  var replies = new ProgramChannel.open(REPLIES);
+  while (true) {
+    var message = requests.receive();
+    if (message.isEmpty) break;
+    replies.send(message);
+  }
+  requests.close();
+  replies.close();
+}
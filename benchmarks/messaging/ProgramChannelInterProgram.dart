@@ -0,0 +1,56 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+import 'dart:typed_data';
+
+import '../BenchmarkBase.dart';
+
+// Sends messages to ProgramChannelEcho.dart, which must run as another
+// program in the same VM, and receives its replies. Export snapshots of both
+// and run them together, e.g. with
+//
+//   out/ReleaseX64/multiprogram_cc_test parallel \
+//       ProgramChannelInterProgram.snapshot 0 ProgramChannelEcho.snapshot 0
+
+const String REQUESTS = "benchmark_requests";
+const String REPLIES = "benchmark_replies";
+
+// Number of bytes in each message.
+const int MESSAGE_SIZE = 256;
+const int MESSAGES = 64;
+
+void main() {
+  new ProgramChannelInterProgramBenchmark().report();
+}
+
+class ProgramChannelInterProgramBenchmark extends BenchmarkBase {
+  ProgramChannel requests;
+  ProgramChannel replies;
+  Uint8List message;
+
+  ProgramChannelInterProgramBenchmark()
+      : super("ProgramChannelInterProgram");
+
+  void setup() {
+    requests = new ProgramChannel.open(REQUESTS);
+    replies = new ProgramChannel.open(REPLIES);
+    message = new Uint8List(MESSAGE_SIZE);
+    for (int i = 0; i < MESSAGE_SIZE; i++) message[i] = i & 0xff;
+  }
+
+  void teardown() {
+    // Stops the other program.
+    requests.send([]);
+    requests.close();
+    replies.close();
+  }
+
+  void exercise() => run();
+
+  void run() {
+    for (int i = 0; i < MESSAGES; i++) requests.send(message);
+    for (int i = 0; i < MESSAGES; i++) replies.receive();
+  }
+}
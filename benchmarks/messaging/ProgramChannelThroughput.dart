@@ -0,0 +1,40 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+import 'dart:typed_data';
+
+import '../BenchmarkBase.dart';
+
+// Number of bytes in each message.
+const int MESSAGE_SIZE = 256;
+const int MESSAGES = 64;
+
+void main() {
+  new ProgramChannelThroughputBenchmark().report();
+}
+
+class ProgramChannelThroughputBenchmark extends BenchmarkBase {
+  ProgramChannel channel;
+  Uint8List message;
+
+  ProgramChannelThroughputBenchmark() : super("ProgramChannelThroughput");
+
+  void setup() {
+    channel = new ProgramChannel.open("benchmark");
+    message = new Uint8List(MESSAGE_SIZE);
+    for (int i = 0; i < MESSAGE_SIZE; i++) message[i] = i & 0xff;
+  }
+
+  void teardown() {
+    channel.close();
+  }
+
+  void exercise() => run();
+
+  void run() {
+    for (int i = 0; i < MESSAGES; i++) channel.send(message);
+    for (int i = 0; i < MESSAGES; i++) channel.receive();
+  }
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Measures the latency of request/response round trips between two
+// processes and reports the median and the 99th percentile. Run with
+// -Xhandoff_limit=0 to compare against scheduling through the ready queue.
+
+import 'dart:dartino';
+
+import 'utils.dart';
+
+const int ROUND_TRIPS = 100000;
+
+void main() {
+  Channel input = new Channel();
+  Port port = new Port(input);
+  Process.spawnDetached(() => portResponder(port));
+  Port output = input.receive();
+
+  // Warm up.
+  int i = DEFAULT_MESSAGES;
+  while (i > 0) {
+    output.send(i);
+    i = input.receive();
+  }
+
+  List<int> samples = new List<int>(ROUND_TRIPS);
+  Stopwatch watch = new Stopwatch()..start();
+  for (int n = 0; n < ROUND_TRIPS; n++) {
+    int start = watch.elapsedTicks;
+    output.send(2);
+    input.receive();
+    samples[n] = watch.elapsedTicks - start;
+  }
+  output.send(0);
+  input.receive();
+
+  samples.sort();
+  report("RoundTripLatencyP50", samples[ROUND_TRIPS ~/ 2], watch.frequency);
+  report("RoundTripLatencyP99", samples[ROUND_TRIPS * 99 ~/ 100],
+         watch.frequency);
+}
+
+void report(String name, int ticks, int frequency) {
+  // Report nanoseconds, as round trips take well below a microsecond.
+  int nanos = ticks * 1000000000 ~/ frequency;
+  print("$name(RunTime): $nanos ns.");
+}
@@ -14,15 +14,22 @@ const int PING_PONG_COUNT = 1000;
 
 class SocketBenchmark extends BenchmarkBase {
   final int clients;
+  // Whether the sockets use persistent event handler registrations.
+  final bool persistent;
+  // Whether the VM buffers the data the sockets receive.
+  final bool buffered;
 
   final channel = new Channel();
   var port;
   int serverSocketPort;
   var serverPort;
 
-  SocketBenchmark(int clients)
-    : super("SocketPingPong$clients"),
-      this.clients = clients;
+  SocketBenchmark(int clients, {bool persistent: false, bool buffered: false})
+    : super("SocketPingPong${persistent ? 'Persistent' : ''}"
+            "${buffered ? 'Buffered' : ''}$clients"),
+      this.clients = clients,
+      this.persistent = persistent,
+      this.buffered = buffered;
 
   static void acceptProcess(Socket socket) {
     var buffer = new Uint8List(MESSAGE_SIZE).buffer;
@@ -33,10 +40,11 @@ class SocketBenchmark extends BenchmarkBase {
     socket.close();
   }
 
-  static void serverProcess(port) {
+  static void serverProcess(port, bool persistent, bool buffered) {
     var channel = new Channel();
     port.send(new Port(channel));
-    var server = new ServerSocket("127.0.0.1", 0);
+    var server = new ServerSocket("127.0.0.1", 0,
+                                  persistent: persistent, buffered: buffered);
     port.send(server.port);
 
     int count;
@@ -53,7 +61,10 @@ class SocketBenchmark extends BenchmarkBase {
   void setup() {
     port = new Port(channel);
     var localPort = port;
-    Process.spawnDetached(() => serverProcess(localPort));
+    bool localPersistent = persistent;
+    bool localBuffered = buffered;
+    Process.spawnDetached(
+        () => serverProcess(localPort, localPersistent, localBuffered));
     serverPort = channel.receive();
     serverSocketPort = channel.receive();
   }
@@ -66,10 +77,13 @@ class SocketBenchmark extends BenchmarkBase {
 
   void run() {
     serverPort.send(clients);
+    bool localPersistent = persistent;
+    bool localBuffered = buffered;
     for (int i = 0; i < clients; i++) {
       var channel = new Channel();
       var handshakePort = new Port(channel);
-      Process.spawnDetached(() => clientProcess(handshakePort));
+      Process.spawnDetached(
+          () => clientProcess(handshakePort, localPersistent, localBuffered));
       var clientPort = channel.receive();
       clientPort.send(serverSocketPort);
       clientPort.send(port);
@@ -79,11 +93,13 @@ class SocketBenchmark extends BenchmarkBase {
     }
   }
 
-  static void clientProcess(port) {
+  static void clientProcess(port, bool persistent, bool buffered) {
     var channel = new Channel();
     port.send(new Port(channel));
 
-    var socket = new Socket.connect("127.0.0.1", channel.receive());
+    var socket = new Socket.connect("127.0.0.1", channel.receive(),
+                                    persistent: persistent,
+                                    buffered: buffered);
     port = channel.receive();
     var buffer = new Uint8List(MESSAGE_SIZE).buffer;
     for (int i = 0; i < PING_PONG_COUNT; i++) {
@@ -0,0 +1,9 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'SocketBase.dart';
+
+void main() {
+  new SocketBenchmark(1, buffered: true).report();
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Measures the latency of socket ping-pongs between two processes and
+// reports the median and the 99th percentile. Every ping wakes up the
+// receiving process through the event handler. Run with -Xidle_spin_count=0
+// to compare against workers that go to sleep right away.
+
+import 'dart:dartino';
+import 'dart:typed_data';
+
+import 'package:socket/socket.dart';
+
+const int MESSAGE_SIZE = 256;
+const int PING_PONGS = 10000;
+
+void main() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  Process.spawnDetached(() => serverProcess(port));
+  int serverSocketPort = channel.receive();
+
+  var socket = new Socket.connect("127.0.0.1", serverSocketPort);
+  var buffer = new Uint8List(MESSAGE_SIZE).buffer;
+  List<int> samples = new List<int>(PING_PONGS);
+  Stopwatch watch = new Stopwatch()..start();
+  for (int i = 0; i < PING_PONGS; i++) {
+    int start = watch.elapsedTicks;
+    socket.write(buffer);
+    if (socket.read(MESSAGE_SIZE) == null) throw "Bad socket response";
+    samples[i] = watch.elapsedTicks - start;
+  }
+  socket.close();
+
+  samples.sort();
+  report("SocketPingPongLatencyP50", samples[PING_PONGS ~/ 2],
+         watch.frequency);
+  report("SocketPingPongLatencyP99", samples[PING_PONGS * 99 ~/ 100],
+         watch.frequency);
+}
+
+void serverProcess(Port port) {
+  var server = new ServerSocket("127.0.0.1", 0);
+  port.send(server.port);
+  var socket = server.accept();
+  var buffer = new Uint8List(MESSAGE_SIZE).buffer;
+  while (socket.read(MESSAGE_SIZE) != null) {
+    socket.write(buffer);
+  }
+  socket.close();
+  server.close();
+}
+
+void report(String name, int ticks, int frequency) {
+  int micros = ticks * 1000000 ~/ frequency;
+  print("$name(RunTime): $micros us.");
+}
@@ -0,0 +1,40 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Measures arming and cancelling timers while many idle timers are pending,
+// the pattern of keepalive and idle timeouts in servers, and how late a
+// short timer fires under that load.
+
+import 'dart:async';
+
+const int IDLE_TIMERS = 10000;
+const int CHURN_ROUNDS = 10;
+const Duration IDLE_TIMEOUT = const Duration(seconds: 30);
+const Duration SHORT_TIMEOUT = const Duration(microseconds: 500);
+
+void main() {
+  List<Timer> timers = new List<Timer>(IDLE_TIMERS);
+  for (int i = 0; i < IDLE_TIMERS; i++) {
+    timers[i] = new Timer(IDLE_TIMEOUT, () {});
+  }
+
+  // Every round pushes out all idle timers by cancelling and re-arming them.
+  Stopwatch watch = new Stopwatch()..start();
+  for (int round = 0; round < CHURN_ROUNDS; round++) {
+    for (int i = 0; i < IDLE_TIMERS; i++) {
+      timers[i].cancel();
+      timers[i] = new Timer(IDLE_TIMEOUT, () {});
+    }
+  }
+  int operations = 2 * IDLE_TIMERS * CHURN_ROUNDS;
+  int nanos = watch.elapsedMicroseconds * 1000 ~/ operations;
+  print("TimerChurn(RunTime): $nanos ns.");
+
+  Stopwatch lateness = new Stopwatch()..start();
+  new Timer(SHORT_TIMEOUT, () {
+    int late = lateness.elapsedMicroseconds - SHORT_TIMEOUT.inMicroseconds;
+    print("TimerChurnLateness(RunTime): $late us.");
+    for (Timer timer in timers) timer.cancel();
+  });
+}
@@ -22,6 +22,7 @@
 
 typedef void* ServiceId;
 typedef void* MethodId;
+typedef void* ServiceQueueId;
 
 typedef void (*ServiceApiCallback)(void* buffer);
 
@@ -36,8 +37,15 @@ DARTINO_EXPORT void ServiceApiSetup();
 // service API in order to free up resources.
 DARTINO_EXPORT void ServiceApiTearDown();
 
+// Returns the id of the service registered under [name], waiting for it to
+// be registered if necessary. Ids stay valid until the service terminates,
+// so they can be resolved once and used for any number of invocations.
 DARTINO_EXPORT ServiceId ServiceApiLookup(const char* name);
 
+// Like ServiceApiLookup, but returns kNoServiceId instead of waiting if no
+// service is registered under [name].
+DARTINO_EXPORT ServiceId ServiceApiTryLookup(const char* name);
+
 DARTINO_EXPORT void ServiceApiInvoke(ServiceId service,
                                     MethodId method,
                                     void* buffer,
@@ -49,6 +57,35 @@ DARTINO_EXPORT void ServiceApiInvokeAsync(ServiceId service,
                                          void* buffer,
                                          int size);
 
+// Completion queues collect the results of requests posted with
+// ServiceApiInvokeQueued. Posting does not block and the request buffers are
+// handed back in batches once the service has produced their results. All
+// posted requests must be collected before the queue is deleted.
+DARTINO_EXPORT ServiceQueueId ServiceApiCreateCompletionQueue();
+
+DARTINO_EXPORT void ServiceApiDeleteCompletionQueue(ServiceQueueId queue);
+
+DARTINO_EXPORT void ServiceApiInvokeQueued(ServiceId service,
+                                          MethodId method,
+                                          ServiceQueueId queue,
+                                          void* buffer,
+                                          int size);
+
+// Stores up to [max] completed request buffers in [buffers], in completion
+// order, and returns the number stored. Returns 0 without blocking if no
+// requests have completed.
+DARTINO_EXPORT int ServiceApiPollCompletions(ServiceQueueId queue,
+                                            void** buffers,
+                                            int max);
+
+// Like ServiceApiPollCompletions, but blocks until at least one request has
+// completed. The queue is polled [spin_count] times before the calling
+// thread goes to sleep, which trades CPU time for lower latency.
+DARTINO_EXPORT int ServiceApiWaitForCompletions(ServiceQueueId queue,
+                                               void** buffers,
+                                               int max,
+                                               int spin_count);
+
 DARTINO_EXPORT void ServiceApiTerminate(ServiceId service);
 
 #endif  // INCLUDE_SERVICE_API_H_
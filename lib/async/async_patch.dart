@@ -35,14 +35,15 @@ Channel _ensureEventQueue() {
   }
 }
 
+// Timers are scheduled in microseconds since the epoch.
 int get _currentTimestamp {
-  return new DateTime.now().millisecondsSinceEpoch;
+  return new DateTime.now().microsecondsSinceEpoch;
 }
 
 // TODO(ajohnsen): We should create a heap-like structure in Dart, so we only
 // have one active port/channel per process.
 class _DartinoTimer implements Timer {
-  final int _milliseconds;
+  final int _microseconds;
   var _callback;
   int _timestamp = 0;
   _DartinoTimer _next;
@@ -50,10 +51,10 @@ class _DartinoTimer implements Timer {
   Channel _channel;
   Port _port;
 
-  bool get _isPeriodic => _milliseconds >= 0;
+  bool get _isPeriodic => _microseconds >= 0;
 
   _DartinoTimer(this._timestamp, this._callback)
-      : _milliseconds = -1 {
+      : _microseconds = -1 {
     _channel = new Channel();
     _port = new Port(_channel);
     _schedule();
@@ -61,7 +62,7 @@ class _DartinoTimer implements Timer {
 
   _DartinoTimer.periodic(this._timestamp,
                         void callback(Timer timer),
-                        this._milliseconds) {
+                        this._microseconds) {
     _callback = () { callback(this); };
     _channel = new Channel();
     _port = new Port(_channel);
@@ -85,7 +86,7 @@ class _DartinoTimer implements Timer {
 
   void _reschedule() {
     assert(_isPeriodic);
-    _timestamp += _milliseconds;
+    _timestamp += _microseconds;
     _schedule();
   }
 
@@ -102,16 +103,16 @@ class _DartinoTimer implements Timer {
 
 @patch class Timer {
   @patch static Timer _createTimer(Duration duration, void callback()) {
-    int milliseconds = max(0, duration.inMilliseconds);
-    return new _DartinoTimer(_currentTimestamp + milliseconds, callback);
+    int microseconds = max(0, duration.inMicroseconds);
+    return new _DartinoTimer(_currentTimestamp + microseconds, callback);
   }
 
   @patch static Timer _createPeriodicTimer(Duration duration,
                                            void callback(Timer timer)) {
-    int milliseconds = max(0, duration.inMilliseconds);
-    return new _DartinoTimer.periodic(_currentTimestamp + milliseconds,
+    int microseconds = max(0, duration.inMicroseconds);
+    return new _DartinoTimer.periodic(_currentTimestamp + microseconds,
                                      callback,
-                                     milliseconds);
+                                     microseconds);
   }
 }
 
@@ -5,6 +5,7 @@
 library dart.dartino;
 
 import 'dart:dartino._system' as dartino;
+import 'dart:typed_data';
 
 /// Fibers are lightweight co-operative multitask units of execution. They
 /// are scheduled on top of OS-level threads, but they are cheap to create
@@ -31,6 +32,7 @@ class Fiber {
   // the [Fiber] class.
   static Fiber _current;
   static Fiber _idleFibers;
+  static Coroutine _exitedCoroutine;
 
   Fiber._initial() {
     _previous = this;
@@ -39,6 +41,13 @@ class Fiber {
 
   Fiber._forked(entry) {
     current;  // Force initialization of fiber sub-system.
+    // The last exited fiber no longer runs on its stack, so it can be
+    // reused for this one.
+    Coroutine exited = _exitedCoroutine;
+    if (exited != null) {
+      _exitedCoroutine = null;
+      exited._recycleStack();
+    }
     _coroutine = new Coroutine((ignore) {
       dartino.runToEnd(entry);
     });
@@ -107,6 +116,7 @@ class Fiber {
     // Suspend the current fiber. It will never wake up again.
     Fiber next = _suspendFiber(fiber, true);
     fiber._coroutine = null;
+    _exitedCoroutine = Coroutine._coroutineCurrent();
     _schedule(next);
   }
 
@@ -211,10 +221,10 @@ class Coroutine {
     _caller = _coroutineCurrent();
     var result = dartino.coroutineChange(this, argument);
 
-    // If the called coroutine is done now, we clear the
-    // stack reference in it so the memory can be reclaimed.
+    // If the called coroutine is done now, we hand its stack
+    // back to the VM so it can be reused by new coroutines.
     if (isDone) {
-      _stack = null;
+      _recycleStack();
     } else {
       _caller = null;
     }
@@ -240,8 +250,15 @@ class Coroutine {
     dartino.coroutineChange(caller, result);
   }
 
+  // Must only be called when this coroutine will never run again. The VM
+  // clears [_stack] unless this is the current coroutine.
+  void _recycleStack() {
+    _coroutineRecycleStack(this);
+  }
+
   @dartino.native external static _coroutineCurrent();
   @dartino.native external static _coroutineNewStack(coroutine, entry);
+  @dartino.native external static _coroutineRecycleStack(coroutine);
 }
 
 class ProcessDeath {
@@ -418,9 +435,27 @@ class Process {
     throw new ArgumentError();
   }
 
+  // Channel and message pairs received in one go by [_handleMessages]. The
+  // slots are cleared once they have been handled, so the buffer does not
+  // keep delivered messages alive.
+  static final List _batch = new List(64);
+
   static void _handleMessages() {
-    Channel channel;
-    while ((channel = _queueGetChannel()) != null) {
+    List batch = _batch;
+    while (true) {
+      int count = _queueGetMessages(batch);
+      for (int i = 0; i < count; i += 2) {
+        Channel channel = batch[i];
+        var message = batch[i + 1];
+        batch[i] = null;
+        batch[i + 1] = null;
+        channel.send(message);
+      }
+      if (count == batch.length) continue;
+
+      // The next message, if any, cannot be received in a batch.
+      Channel channel = _queueGetChannel();
+      if (channel == null) return;
       var message = _queueGetMessage();
       if (message is ProcessDeath) {
         message = _queueSetupProcessDeath(message);
@@ -431,10 +466,25 @@ class Process {
 
   @dartino.native external static Process get current;
   @dartino.native external static _queueGetMessage();
+  @dartino.native external static int _queueGetMessages(List batch);
   @dartino.native external static _queueSetupProcessDeath(ProcessDeath message);
   @dartino.native external static Channel _queueGetChannel();
 }
 
+// What happens when sending to a bounded port that is full.
+//
+// This enum must be kept in sync with the Port::OverflowPolicy enum in
+// src/vm/port.h.
+enum PortOverflow {
+  // The sender waits until the receiver has made room.
+  block,
+  // The message is sent and the oldest queued message is dropped when the
+  // receiver gets to it.
+  dropOldest,
+  // The send throws a StateError.
+  fail,
+}
+
 // Ports allow you to send messages to a channel. Ports are
 // are transferable and can be sent between processes.
 class Port {
@@ -445,26 +495,124 @@ class Port {
     return Port._create(channel);
   }
 
+  // Create a port with room for [capacity] messages that have not yet been
+  // received by the process owning [channel]. When the port is full,
+  // [overflow] decides what happens to new messages.
+  factory Port.bounded(Channel channel,
+                       int capacity,
+                       {PortOverflow overflow: PortOverflow.block}) {
+    if (capacity is! int || capacity <= 0) throw new ArgumentError(capacity);
+    Port port = Port._create(channel);
+    port._setCapacity(capacity, overflow.index);
+    return port;
+  }
+
   // TODO(kasperl): Temporary debugging aid.
   int get id => _port;
 
-  // Send a message to the channel. Not blocking.
+  // The number of messages that can be queued, or zero if unbounded.
+  @dartino.native external int get capacity;
+
+  // The number of messages sent to this port that the owning process has
+  // not yet received.
+  @dartino.native external int get queueLength;
+
+  // Send a message to the channel. Not blocking, unless the port is full
+  // and was created with [PortOverflow.block].
   @dartino.native void send(message) {
     switch (dartino.nativeError) {
       case dartino.wrongArgumentType:
         throw new ArgumentError();
       case dartino.illegalState:
         throw new StateError("Port is closed.");
+      case dartino.indexOutOfBounds:
+        _waitUntilNotFull();
+        send(message);
+        break;
       default:
         throw dartino.nativeError;
     }
   }
 
+  // Send all [messages] to the channel in order. Not blocking. The messages
+  // are enqueued at once and the receiver is only woken up once. The
+  // capacity of a bounded port is only checked before the messages are
+  // enqueued.
+  void sendAll(List messages) {
+    _sendList(dartino.extractFixedList(messages), messages.length);
+  }
+
+  @dartino.native void _sendList(messages, int count) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError();
+      case dartino.illegalState:
+        throw new StateError("Port is closed.");
+      case dartino.indexOutOfBounds:
+        _waitUntilNotFull();
+        _sendList(messages, count);
+        break;
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  // Send a copy of [message] to the channel. Unlike [send], [message] may
+  // be a mutable object graph; the receiver gets a private copy of it in a
+  // single pass. Immutable parts of the graph are shared, not copied.
+  // Blocks like [send] if the port is full.
+  @dartino.native void sendCopy(message) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError(message);
+      case dartino.illegalState:
+        throw new StateError("Port is closed.");
+      case dartino.indexOutOfBounds:
+        _waitUntilNotFull();
+        sendCopy(message);
+        break;
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  // Send [memory], a ForeignMemory, to the channel without copying the
+  // memory. The receiver gets a ForeignMemory for the same address and
+  // [memory] becomes empty. Blocks like [send] if the port is full.
+  @dartino.native void transfer(memory) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError(memory);
+      case dartino.illegalState:
+        throw new StateError("Port is closed.");
+      case dartino.indexOutOfBounds:
+        _waitUntilNotFull();
+        transfer(memory);
+        break;
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  void _waitUntilNotFull() {
+    if (_overflow() != PortOverflow.block.index) {
+      throw new StateError("Port is full.");
+    }
+    while (queueLength >= capacity) {
+      // Receive our own messages, in case the port is owned by this process,
+      // and let other processes run.
+      Process._handleMessages();
+      dartino.yield(dartino.InterruptKind.interrupt.index);
+    }
+  }
+
   @dartino.native void _sendExit(value) {
     throw new StateError("Port is closed.");
   }
 
   @dartino.native external static Port _create(Channel channel);
+  @dartino.native external void _setCapacity(int capacity, int overflow);
+  @dartino.native external int _overflow();
 }
 
 class Channel {
@@ -541,6 +689,135 @@ class _ChannelEntry {
   _ChannelEntry(this.message, this.sender);
 }
 
+// A named channel for byte messages between programs running in the same
+// VM. Programs do not share heaps, so messages are copied through a buffer
+// owned by the VM. Any process can send to a channel, but only one fiber
+// may receive from it at a time.
+class ProgramChannel {
+  // A Smi stores the aligned pointer to the C++ channel object.
+  int _handle;
+  Channel _wakeup;
+  Port _wakeupPort;
+  bool _receiving = false;
+
+  // Open the channel called [name], creating it with room for at least
+  // [capacity] bytes if no program has opened it yet.
+  ProgramChannel.open(String name, {int capacity: 65536}) {
+    if (capacity is! int || capacity <= 0) throw new ArgumentError(capacity);
+    _open(name, capacity);
+  }
+
+  // Send [bytes] to the channel. [bytes] is typed data, a [ByteBuffer] or a
+  // list of byte values. Typed data and byte buffers are copied into the
+  // channel directly from their foreign memory. If the channel is full, the
+  // sender waits until the receiver has made room.
+  void send(bytes) {
+    // Dartino's typed data is backed by foreign memory, which is kept alive
+    // by [foreign] until the message has been copied.
+    var foreign;
+    int offset = 0;
+    int length;
+    if (bytes is TypedData) {
+      foreign = bytes.buffer.getForeign();
+      offset = bytes.offsetInBytes;
+      length = bytes.lengthInBytes;
+    } else if (bytes is ByteBuffer) {
+      foreign = bytes.getForeign();
+      length = bytes.lengthInBytes;
+    } else {
+      length = bytes.length;
+      Uint8List list = new Uint8List(length);
+      for (int i = 0; i < length; i++) {
+        var byte = bytes[i];
+        if (byte is! int || byte < 0 || byte > 255) {
+          throw new ArgumentError(bytes);
+        }
+        list[i] = byte;
+      }
+      foreign = list.buffer.getForeign();
+    }
+    while (!_send(foreign.address + offset, length)) {
+      dartino.yield(dartino.InterruptKind.interrupt.index);
+    }
+  }
+
+  // Receive the next message. If no messages are available the receiver
+  // blocks. Throws a [StateError] if another fiber or process is already
+  // waiting for a message.
+  Uint8List receive() {
+    if (_receiving) throw new StateError("Channel already has a receiver.");
+    _receiving = true;
+    try {
+      while (true) {
+        int size = _nextSize();
+        if (size >= 0) {
+          Uint8List bytes = new Uint8List(size);
+          _receive(bytes.buffer.getForeign().address, size);
+          return bytes;
+        }
+        if (_wakeup == null) {
+          _wakeup = new Channel();
+          _wakeupPort = new Port(_wakeup);
+        }
+        if (_wait(_wakeupPort)) _wakeup.receive();
+      }
+    } finally {
+      _receiving = false;
+    }
+  }
+
+  // Drop this program's reference to the channel. The channel is deleted
+  // once all programs have closed it.
+  void close() {
+    _close();
+  }
+
+  @dartino.native void _open(String name, int capacity) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError(name);
+      case dartino.indexOutOfBounds:
+        throw new RangeError.value(capacity);
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  @dartino.native void _close() {
+    throw new StateError("Channel is closed.");
+  }
+
+  @dartino.native bool _send(int address, int length) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError();
+      case dartino.illegalState:
+        throw new StateError("Channel is closed.");
+      case dartino.indexOutOfBounds:
+        throw new RangeError.value(length);
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  @dartino.native int _nextSize() {
+    throw new StateError("Channel is closed.");
+  }
+
+  @dartino.native void _receive(int address, int length) {
+    throw new StateError("Channel is closed.");
+  }
+
+  @dartino.native bool _wait(Port port) {
+    switch (dartino.nativeError) {
+      case dartino.indexOutOfBounds:
+        throw new StateError("Channel already has a receiver.");
+      default:
+        throw new StateError("Channel is closed.");
+    }
+  }
+}
+
 bool isImmutable(Object object) => _isImmutable(object);
 
 @dartino.native external bool _isImmutable(String string);
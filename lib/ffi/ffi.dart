@@ -82,6 +82,9 @@ abstract class Foreign {
   @dartino.native static int _errno() {
     throw new UnsupportedError('_errno');
   }
+  @dartino.native static void _setErrno(int value) {
+    throw new UnsupportedError('_setErrno');
+  }
   @dartino.native static int _platform() {
     throw new UnsupportedError('_platform');
   }
@@ -124,6 +127,21 @@ class ForeignFunction extends Foreign {
   /// conventions.
   const ForeignFunction.fromAddress(this.address, [this._library = null]);
 
+  /// Returns a version of this function that runs on a VM thread set aside
+  /// for blocking calls.
+  ///
+  /// Only the calling process waits for the call to return, while the
+  /// VM's worker threads keep running other processes. Use it for
+  /// functions that may block for a long time, like `getaddrinfo` or a
+  /// `read` from a pipe. The [icall$0], [pcall$0] and [vcall$0] families
+  /// are supported and [Foreign.errno] is the one set by the call.
+  ///
+  /// Memory passed to the function must stay alive until it returns, even
+  /// if the calling process is killed, so it should not be finalized.
+  ForeignFunction get blocking {
+    return new _BlockingForeignFunction(address, _library);
+  }
+
   /// Helper function for retrying functions that follow the POSIX-convention
   /// of returning `-1` and setting `errno` to `EINTR`.
   ///
@@ -374,6 +392,83 @@ class ForeignFunction extends Foreign {
   }
 }
 
+class _BlockingForeignFunction extends ForeignFunction {
+  // These constants must be in sync with the enum BlockingCall::Kind in
+  // src/vm/blocking_call_pool.h.
+  static const int _INT = 0;
+  static const int _POINTER = 1;
+  static const int _VOID = 2;
+
+  _BlockingForeignFunction(int address, ForeignLibrary library)
+      : super.fromAddress(address, library);
+
+  ForeignFunction get blocking => this;
+
+  int icall$0() => _call(_INT, 0);
+  int icall$1(a0) => _call(_INT, 1, a0);
+  int icall$2(a0, a1) => _call(_INT, 2, a0, a1);
+  int icall$3(a0, a1, a2) => _call(_INT, 3, a0, a1, a2);
+  int icall$4(a0, a1, a2, a3) => _call(_INT, 4, a0, a1, a2, a3);
+  int icall$5(a0, a1, a2, a3, a4) => _call(_INT, 5, a0, a1, a2, a3, a4);
+  int icall$6(a0, a1, a2, a3, a4, a5) {
+    return _call(_INT, 6, a0, a1, a2, a3, a4, a5);
+  }
+  int icall$7(a0, a1, a2, a3, a4, a5, a6) {
+    return _call(_INT, 7, a0, a1, a2, a3, a4, a5, a6);
+  }
+
+  ForeignPointer pcall$0() => new ForeignPointer(_call(_POINTER, 0));
+  ForeignPointer pcall$1(a0) => new ForeignPointer(_call(_POINTER, 1, a0));
+  ForeignPointer pcall$2(a0, a1) {
+    return new ForeignPointer(_call(_POINTER, 2, a0, a1));
+  }
+  ForeignPointer pcall$3(a0, a1, a2) {
+    return new ForeignPointer(_call(_POINTER, 3, a0, a1, a2));
+  }
+  ForeignPointer pcall$4(a0, a1, a2, a3) {
+    return new ForeignPointer(_call(_POINTER, 4, a0, a1, a2, a3));
+  }
+  ForeignPointer pcall$5(a0, a1, a2, a3, a4) {
+    return new ForeignPointer(_call(_POINTER, 5, a0, a1, a2, a3, a4));
+  }
+  ForeignPointer pcall$6(a0, a1, a2, a3, a4, a5) {
+    return new ForeignPointer(_call(_POINTER, 6, a0, a1, a2, a3, a4, a5));
+  }
+
+  void vcall$0() { _call(_VOID, 0); }
+  void vcall$1(a0) { _call(_VOID, 1, a0); }
+  void vcall$2(a0, a1) { _call(_VOID, 2, a0, a1); }
+  void vcall$3(a0, a1, a2) { _call(_VOID, 3, a0, a1, a2); }
+  void vcall$4(a0, a1, a2, a3) { _call(_VOID, 4, a0, a1, a2, a3); }
+  void vcall$5(a0, a1, a2, a3, a4) { _call(_VOID, 5, a0, a1, a2, a3, a4); }
+  void vcall$6(a0, a1, a2, a3, a4, a5) {
+    _call(_VOID, 6, a0, a1, a2, a3, a4, a5);
+  }
+  void vcall$7(a0, a1, a2, a3, a4, a5, a6) {
+    _call(_VOID, 7, a0, a1, a2, a3, a4, a5, a6);
+  }
+
+  // Runs the call on the blocking call pool and waits for the errno and the
+  // result to come back.
+  int _call(int kind, int argc,
+            [a0 = 0, a1 = 0, a2 = 0, a3 = 0, a4 = 0, a5 = 0, a6 = 0]) {
+    var channel = new Channel();
+    _submit(address, kind, argc, _convert(a0), _convert(a1), _convert(a2),
+        _convert(a3), _convert(a4), _convert(a5), _convert(a6),
+        new Port(channel));
+    int errno = channel.receive();
+    int result = channel.receive();
+    Foreign._setErrno(errno);
+    return result;
+  }
+
+  @dartino.native static void _submit(int address, int kind, int argc, a0,
+      a1, a2, a3, a4, a5, a6, Port port) {
+    var error = dartino.nativeError;
+    throw (error == dartino.wrongArgumentType) ? new ArgumentError() : error;
+  }
+}
+
 class ForeignDartFunction extends ForeignFunction {
   bool _hasBeenFreed = false;
 
@@ -874,6 +969,70 @@ class ForeignMemory extends _ForeignMemoryHelper {
   }
 }
 
+/**
+ * A range of a file mapped into memory. It is unmapped when [free] is called
+ * or once it is no longer reachable.
+ *
+ * Mapped memory is backed by the file rather than by memory allocated for
+ * it, so unlike finalized [ForeignMemory] it does not make garbage
+ * collections happen sooner.
+ */
+class MappedMemory extends ForeignMemory {
+  /// Whether the memory can be written, which writes through to the file.
+  final bool isWritable;
+
+  MappedMemory._(int address, int length, this.isWritable)
+      : super.fromAddress(address, length) {
+    _markForUnmapping(length);
+  }
+
+  /**
+   * Map [length] bytes at [offset] in the file with the descriptor [fd].
+   * The [offset] must be a multiple of the page size. The mapping stays
+   * valid after the file is closed.
+   *
+   * Throws a [RangeError] if the range is not inside the file, an
+   * [UnsupportedError] if the platform cannot map files, and a [StateError]
+   * if the file could not be mapped.
+   */
+  factory MappedMemory.map(int fd, int offset, int length,
+                           {bool writable: false}) {
+    int address = _map(fd, offset, length, writable);
+    if (address < 0) {
+      throw new StateError("Failed to map file: errno ${-address}.");
+    }
+    return new MappedMemory._(address, length, writable);
+  }
+
+  void free() {
+    if (length > 0) _unmap();
+    address = 0;
+    length = 0;
+  }
+
+  @dartino.native static int _map(int fd, int offset, int length,
+                                  bool writable) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError();
+      case dartino.indexOutOfBounds:
+        throw new RangeError("Invalid descriptor, offset or length.");
+      case dartino.illegalState:
+        throw new UnsupportedError("Mapping files is not supported.");
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  @dartino.native void _markForUnmapping(int length) {
+    throw new ArgumentError();
+  }
+
+  @dartino.native void _unmap() {
+    throw new StateError("Failed to unmap file.");
+  }
+}
+
 // NOTE We could make this a view on a memory object instead.
 class Struct extends ForeignMemory {
   final wordSize;
@@ -13,6 +13,13 @@ const int CLOSE_EVENT       = 1 << 2;
 // The event source signaled an error.
 const int ERROR_EVENT       = 1 << 3;
 
+// Asynchronous I/O operations, see [EventHandler.submitIo].
+const int IO_READ           = 0;
+const int IO_WRITE          = 1;
+const int IO_FSYNC          = 2;
+const int IO_ACCEPT         = 3;
+const int IO_CONNECT        = 4;
+
 class EventHandler {
   EventHandler._internal() {
     // The actual initialization is done in the VM.
@@ -43,6 +50,84 @@ class EventHandler {
     _eventHandlerAdd(id, port, mask);
   }
 
+  /**
+   * Register the port [port] for all future events of the event source [id].
+   *
+   * Unlike [registerPortForNextEvent], the registration persists until
+   * [EventRegistration.unregister] is called. Events are edge-triggered and
+   * cached by the VM: they are only sent to [port] when the owner of the
+   * registration waits for them with [EventRegistration.wait].
+   *
+   * An [ArgumentError] is thrown if the event source is not supported.
+   * A [StateError] is thrown if the port could not be registered or if the
+   * platform does not support persistent registrations.
+   */
+  EventRegistration register(Object id, Port port) {
+    if (port is! Port) throw new ArgumentError(port);
+    return new EventRegistration._(_eventHandlerRegister(id, port));
+  }
+
+  /**
+   * Register the port [port] for all future events of the socket [id], like
+   * [register], and buffer the data received on it in the VM.
+   *
+   * [capacity] is the size of the buffer and must be a power of two between
+   * 256 bytes and 16 MB. See [SocketStream].
+   *
+   * An [ArgumentError] is thrown if the event source is not supported.
+   * A [StateError] is thrown if the stream could not be opened or if the
+   * platform does not support persistent registrations.
+   */
+  SocketStream openStream(Object id, Port port, [int capacity = 65536]) {
+    if (port is! Port) throw new ArgumentError(port);
+    if (capacity is! int) throw new ArgumentError(capacity);
+    return new SocketStream._(SocketStream._open(id, port, capacity), capacity);
+  }
+
+  /**
+   * Start the I/O operation [kind] on the file descriptor [fd]. Its result
+   * is sent to [port] once it completes: the number of bytes transferred,
+   * the accepted file descriptor or a negative errno value.
+   *
+   * [IO_READ] and [IO_WRITE] transfer [length] bytes at the foreign
+   * [address], at [offset] in the file or at the file position if [offset]
+   * is negative. [IO_CONNECT] connects to the socket address of [length]
+   * bytes at [address]. The memory at [address] must stay allocated until
+   * the result has been received.
+   *
+   * Operations run without blocking the calling process' worker thread or
+   * the event handler. Operations on non-blocking sockets and pipes wait
+   * for the descriptor to become ready, which needs a descriptor without a
+   * persistent registration, see [register].
+   *
+   * A [RangeError] is thrown if [length] does not fit in 32 bits or the
+   * descriptor cannot be used. Returns false if the platform does not
+   * support asynchronous I/O.
+   */
+  bool submitIo(int kind, int fd, int address, int length, int offset,
+                Port port) {
+    if (port is! Port) throw new ArgumentError(port);
+    return _eventHandlerSubmitIo(kind, fd, address, length, offset, port);
+  }
+
+  /**
+   * Transfer [length] bytes at [offset] in the file [file] to the
+   * non-blocking socket [socket], without copying them into the heap. The
+   * result is sent to [port] once the transfer completes: the number of
+   * bytes transferred, which is less than [length] if the file ends before,
+   * or a negative errno value.
+   *
+   * The transfer continues whenever the socket becomes writable, so the
+   * socket must not be used until the result has been received. It must
+   * not have a persistent registration, see [register].
+   *
+   * Returns false if the platform does not support file transfers.
+   */
+  bool sendFile(int socket, int file, int offset, int length, Port port) {
+    if (port is! Port) throw new ArgumentError(port);
+    return _eventHandlerSendFile(socket, file, offset, length, port);
+  }
+
   @dartino.native static void _eventHandlerAdd(Object id, Port port,
       int event_kinds) {
     switch (dartino.nativeError) {
@@ -60,6 +145,108 @@ class EventHandler {
         throw dartino.nativeError;
     }
   }
+
+  @dartino.native static int _eventHandlerRegister(Object id, Port port) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError(id);
+      case dartino.indexOutOfBounds:
+        throw new StateError("The port could not be registered.");
+      case dartino.illegalState:
+        throw new StateError("Operation not supported.");
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  @dartino.native static int _eventHandlerWait(int handle, int mask) {
+    switch (dartino.nativeError) {
+      case dartino.illegalState:
+        throw new StateError("Not registered.");
+      default:
+        throw new ArgumentError(mask);
+    }
+  }
+
+  @dartino.native static void _eventHandlerMarkReady(int handle, int mask) {
+    switch (dartino.nativeError) {
+      case dartino.illegalState:
+        throw new StateError("Not registered.");
+      default:
+        throw new ArgumentError(mask);
+    }
+  }
+
+  @dartino.native static void _eventHandlerUnregister(int handle) {
+    throw new StateError("Not registered.");
+  }
+
+  @dartino.native static bool _eventHandlerSubmitIo(int kind, int fd,
+      int address, int length, int offset, Port port) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError();
+      case dartino.indexOutOfBounds:
+        throw new RangeError("Invalid operation, descriptor or length.");
+      case dartino.illegalState:
+        return false;
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  @dartino.native static bool _eventHandlerSendFile(int socket, int file,
+      int offset, int length, Port port) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError();
+      case dartino.indexOutOfBounds:
+        throw new RangeError("Invalid descriptor, offset or length.");
+      case dartino.illegalState:
+        return false;
+      default:
+        throw dartino.nativeError;
+    }
+  }
+}
+
+/**
+ * A persistent registration of an event source, see [EventHandler.register].
+ *
+ * Once it has been unregistered, its methods throw a [StateError].
+ */
+class EventRegistration {
+  final int _handle;
+
+  EventRegistration._(this._handle);
+
+  /**
+   * Returns the pending events in [mask] together with pending close and
+   * error events, and clears the events in [mask].
+   *
+   * If no such events are pending, 0 is returned and the events are sent to
+   * the registered port once they happen. The message is 0 if the events
+   * arrived while [wait] was running, in which case [wait] should be called
+   * again.
+   */
+  int wait(int mask) => EventHandler._eventHandlerWait(_handle, mask);
+
+  /**
+   * Mark the events in [mask] as pending again. Use it when an operation
+   * did not drain the event source, as no new event is reported until it
+   * has been drained.
+   */
+  void markReady(int mask) {
+    EventHandler._eventHandlerMarkReady(_handle, mask);
+  }
+
+  /**
+   * Stop receiving events. The event source must be unregistered before it
+   * is closed.
+   */
+  void unregister() {
+    EventHandler._eventHandlerUnregister(_handle);
+  }
 }
 
 final EventHandler eventHandler = new EventHandler._internal();
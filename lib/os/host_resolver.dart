@@ -0,0 +1,29 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+part of dart.dartino.os;
+
+class HostResolver {
+
+  /// Resolves [host] to an IPv4 address, returned as a 32-bit integer with
+  /// the first byte of the address in the most significant byte. Returns a
+  /// negative `getaddrinfo` error code if [host] could not be resolved.
+  ///
+  /// The lookup runs on a VM thread, so only the calling process waits for
+  /// it. Results are cached by the VM for all processes, failed lookups for
+  /// a shorter time.
+  static int lookupIPv4(String host) {
+    if (host is! String) throw new ArgumentError(host);
+    int result = _lookup(host, null);
+    if (result != null) return result;
+    var channel = new Channel();
+    result = _lookup(host, new Port(channel));
+    if (result != null) return result;
+    return channel.receive();
+  }
+
+  @dartino.native static int _lookup(String host, Port port) {
+    throw new ArgumentError();
+  }
+}
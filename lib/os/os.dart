@@ -10,6 +10,8 @@ import 'dart:dartino.ffi';
 
 part 'native_process.dart';
 part 'event_handler.dart';
+part 'host_resolver.dart';
+part 'socket_stream.dart';
 
 final ForeignFunction _nanosleep = ForeignLibrary.main.lookup("nanosleep");
 
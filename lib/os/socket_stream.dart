@@ -0,0 +1,146 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+part of dart.dartino.os;
+
+/**
+ * A persistent registration of a socket that buffers received data in the
+ * VM, see [EventHandler.openStream].
+ *
+ * The event handler reads into a ring buffer of [capacity] bytes as soon as
+ * data arrives, so reading from the stream takes no system call. A pending
+ * [READ_EVENT] means there is data in the ring.
+ */
+class SocketStream extends EventRegistration {
+  // Must be in sync with SocketStream::kMaxIovecs in src/vm/socket_stream.h.
+  static const int MAX_BUFFERS = 16;
+
+  final int capacity;
+  // The ring owned by the VM.
+  final ForeignMemory _ring;
+  // Pairs of addresses and lengths passed to [_write].
+  final Struct _iovecs;
+  // The number of bytes consumed so far, which locates the ring's start.
+  int _consumed = 0;
+
+  SocketStream._(int handle, int capacity)
+      : capacity = capacity,
+        _ring = new ForeignMemory.fromAddress(_buffer(handle), capacity),
+        _iovecs = new Struct(MAX_BUFFERS * 2),
+        super._(handle);
+
+  /// The number of received bytes in the ring.
+  int get available => _available(_handle);
+
+  /**
+   * Copies up to [length] received bytes to the foreign memory at [address]
+   * and consumes them. Returns the number of bytes copied.
+   */
+  int read(int address, int length) {
+    int read = _read(_handle, address, length);
+    _consumed += read;
+    return read;
+  }
+
+  /**
+   * Returns a view of the first received bytes, without copying them. The
+   * view covers at most [available] bytes, and fewer where the ring wraps
+   * around. It is only valid until the bytes are consumed.
+   */
+  ForeignMemory peek() {
+    int offset = _consumed & (capacity - 1);
+    int length = available;
+    if (offset + length > capacity) length = capacity - offset;
+    return new ForeignMemory.fromAddress(_ring.address + offset, length);
+  }
+
+  /// Drops the first [bytes] received bytes, e.g. after they were [peek]ed.
+  void consume(int bytes) {
+    _consume(_handle, bytes);
+    _consumed += bytes;
+  }
+
+  /**
+   * Writes the foreign buffers at [addresses] with the given [lengths] to
+   * the socket in a single system call. At most [MAX_BUFFERS] buffers can be
+   * written at a time. Returns the number of bytes written, which may be
+   * fewer than requested, or a negative errno value.
+   */
+  int write(List<int> addresses, List<int> lengths) {
+    int count = addresses.length;
+    if (count != lengths.length || count > MAX_BUFFERS) {
+      throw new ArgumentError(lengths);
+    }
+    for (int i = 0; i < count; i++) {
+      _iovecs.setField(2 * i, addresses[i]);
+      _iovecs.setField(2 * i + 1, lengths[i]);
+    }
+    return _write(_handle, _iovecs.address, count);
+  }
+
+  void unregister() {
+    super.unregister();
+    _iovecs.free();
+  }
+
+  @dartino.native static int _open(Object id, Port port, int capacity) {
+    switch (dartino.nativeError) {
+      case dartino.wrongArgumentType:
+        throw new ArgumentError(id);
+      case dartino.indexOutOfBounds:
+        throw new StateError("The stream could not be opened.");
+      case dartino.illegalState:
+        throw new StateError("Operation not supported.");
+      default:
+        throw dartino.nativeError;
+    }
+  }
+
+  @dartino.native static int _buffer(int handle) {
+    switch (dartino.nativeError) {
+      case dartino.illegalState:
+        throw new StateError("Not registered.");
+      default:
+        throw new ArgumentError(handle);
+    }
+  }
+
+  @dartino.native static int _available(int handle) {
+    switch (dartino.nativeError) {
+      case dartino.illegalState:
+        throw new StateError("Not registered.");
+      default:
+        throw new ArgumentError(handle);
+    }
+  }
+
+  @dartino.native static int _read(int handle, int address, int length) {
+    switch (dartino.nativeError) {
+      case dartino.illegalState:
+        throw new StateError("Not registered.");
+      default:
+        throw new ArgumentError(length);
+    }
+  }
+
+  @dartino.native static void _consume(int handle, int bytes) {
+    switch (dartino.nativeError) {
+      case dartino.illegalState:
+        throw new StateError("Not registered.");
+      case dartino.indexOutOfBounds:
+        throw new RangeError.range(bytes, 0, _available(handle));
+      default:
+        throw new ArgumentError(bytes);
+    }
+  }
+
+  @dartino.native static int _write(int handle, int iovecs, int count) {
+    switch (dartino.nativeError) {
+      case dartino.illegalState:
+        throw new StateError("Not registered.");
+      default:
+        throw new ArgumentError(count);
+    }
+  }
+}
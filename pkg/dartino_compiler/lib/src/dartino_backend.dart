@@ -1073,7 +1073,9 @@ class DartinoBackend extends Backend
     int arity = codegen.assembler.functionArity;
     if (name == "Port.send" ||
         name == "Port._sendList" ||
-        name == "Port._sendExit") {
+        name == "Port._sendExit" ||
+        name == "Port.sendCopy" ||
+        name == "Port.transfer") {
       codegen.assembler.invokeNativeYield(arity, descriptor.index);
     } else {
       if (descriptor.isLeaf) {
@@ -128,6 +128,36 @@ abstract class VmCommand {
           ids[i] = CommandBuffer.readInt32FromBuffer(buffer, (i + 1) * 4);
         }
         return new ProcessGetProcessIdsResult(ids);
+      case VmCommandCode.BytecodeProfileResult:
+        int offset = 0;
+        int opcodeCount = CommandBuffer.readInt32FromBuffer(buffer, offset);
+        offset += 4;
+        List<int> opcodes = new List<int>(opcodeCount);
+        for (int i = 0; i < opcodeCount; ++i) {
+          opcodes[i] = CommandBuffer.readInt64FromBuffer(buffer, offset);
+          offset += 8;
+        }
+        int pairCount = CommandBuffer.readInt32FromBuffer(buffer, offset);
+        offset += 4;
+        List<BytecodePairCount> pairs = new List<BytecodePairCount>(pairCount);
+        for (int i = 0; i < pairCount; ++i) {
+          int first = CommandBuffer.readInt32FromBuffer(buffer, offset);
+          int second = CommandBuffer.readInt32FromBuffer(buffer, offset + 4);
+          int count = CommandBuffer.readInt64FromBuffer(buffer, offset + 8);
+          pairs[i] = new BytecodePairCount(first, second, count);
+          offset += 16;
+        }
+        int functionCount = CommandBuffer.readInt32FromBuffer(buffer, offset);
+        offset += 4;
+        Map<int, int> functions = <int, int>{};
+        for (int i = 0; i < functionCount; ++i) {
+          int functionId = translateFunction(
+              CommandBuffer.readInt64FromBuffer(buffer, offset));
+          functions[functionId] =
+              CommandBuffer.readInt64FromBuffer(buffer, offset + 8);
+          offset += 16;
+        }
+        return new BytecodeProfileResult(opcodes, pairs, functions);
       case VmCommandCode.UncaughtException:
         int offset = 0;
         int processId = CommandBuffer.readInt32FromBuffer(buffer, offset);
@@ -1420,6 +1450,47 @@ class ProcessGetProcessIdsResult extends VmCommand {
   String valuesToString() => "ids: $ids";
 }
 
+class BytecodeProfile extends VmCommand {
+  const BytecodeProfile()
+      : super(VmCommandCode.BytecodeProfile);
+
+  /// The peer will respond with [BytecodeProfileResult].
+  int get numberOfResponsesExpected => 1;
+
+  String valuesToString() => "";
+}
+
+class BytecodePairCount {
+  final int first;
+  final int second;
+  final int count;
+
+  const BytecodePairCount(this.first, this.second, this.count);
+
+  String toString() => "BytecodePairCount($first, $second, $count)";
+}
+
+class BytecodeProfileResult extends VmCommand {
+  /// Execution count indexed by bytecode opcode.
+  final List<int> opcodes;
+
+  /// Execution count of each pair of consecutively executed bytecodes.
+  final List<BytecodePairCount> pairs;
+
+  /// Bytecodes executed in each function of the live processes, keyed by
+  /// function id.
+  final Map<int, int> functions;
+
+  const BytecodeProfileResult(this.opcodes, this.pairs, this.functions)
+      : super(VmCommandCode.BytecodeProfileResult);
+
+  int get numberOfResponsesExpected => 0;
+
+  String valuesToString() {
+    return "opcodes: $opcodes, pairs: $pairs, functions: $functions";
+  }
+}
+
 class SessionEnd extends VmCommand {
   const SessionEnd()
       : super(VmCommandCode.SessionEnd);
@@ -1812,6 +1883,9 @@ enum VmCommandCode {
   ProcessGetProcessIds,
   ProcessGetProcessIdsResult,
 
+  BytecodeProfile,
+  BytecodeProfileResult,
+
   SetEntryPoint,
   CreateSnapshot,
   ProgramInfo,
@@ -922,6 +922,13 @@ class DartinoVmContext {
     return response.ids;
   }
 
+  /// Returns the bytecode profile collected so far. The VM must be running
+  /// with `-Xprofile-bytecodes` for the counts to be non-zero.
+  Future<BytecodeProfileResult> bytecodeProfile() async {
+    assert(isSpawned);
+    return await runCommand(const BytecodeProfile());
+  }
+
   Future<BackTrace> processStack(int processId) async {
     assert(isPaused);
     ProcessBacktrace backtraceResponse =
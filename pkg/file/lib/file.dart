@@ -22,10 +22,16 @@
 /// tracker](https://github.com/dartino/sdk/issues/new?title=Add%20title&labels=Area-Package&body=%3Cissue%20description%3E%0A%3Crepro%20steps%3E%0A%3Cexpected%20outcome%3E%0A%3Cactual%20outcome%3E).
 library file;
 
+import 'dart:collection' show ListBase;
+import 'dart:dartino';
+import 'dart:dartino.ffi' show ForeignMemory, MappedMemory;
+import 'dart:dartino.os' as os;
 import 'dart:typed_data';
 
 import 'package:os/os.dart';
 
+part 'src/mapped_file.dart';
+
 final File _stdin = new File._('/dev/stdin', 0);
 final File _stdout = new File._('/dev/stdout', 1);
 final File _stderr = new File._('/dev/stderr', 2);
@@ -109,6 +115,87 @@ class File {
     return buffer;
   }
 
+  /**
+   * Like [write], but the data is written by the VM's event handler, so
+   * only the calling process waits for the disk while other processes keep
+   * running.
+   */
+  void writeAsync(ByteBuffer buffer) {
+    int length = buffer.lengthInBytes;
+    if (length == 0) return;
+    var bounce = new _BounceBuffer(length);
+    try {
+      sys.memcpy(bounce, 0, buffer, 0, length);
+      int result = _submit(os.IO_WRITE, bounce.memory, length);
+      if (result == null) {
+        write(buffer);
+      } else if (result != length) {
+        _error("Failed to write buffer");
+      }
+    } finally {
+      bounce.free();
+    }
+  }
+
+  /**
+   * Like [read], but the data is read by the VM's event handler, so only
+   * the calling process waits for the disk while other processes keep
+   * running.
+   */
+  ByteBuffer readAsync(int maxBytes) {
+    if (maxBytes == 0) return new Uint8List(0).buffer;
+    var bounce = new _BounceBuffer(maxBytes);
+    try {
+      int result = _submit(os.IO_READ, bounce.memory, maxBytes);
+      if (result == null) return read(maxBytes);
+      if (result < 0) _error("Failed to read from file");
+      ByteBuffer buffer = new Uint8List(result).buffer;
+      sys.memcpy(buffer, 0, bounce, 0, result);
+      return buffer;
+    } finally {
+      bounce.free();
+    }
+  }
+
+  // Runs the I/O operation [kind] on the event handler and waits for its
+  // result. Returns null if asynchronous I/O is not supported.
+  int _submit(int kind, ForeignMemory memory, int length) {
+    var channel = new Channel();
+    var port = new Port(channel);
+    int address = memory == null ? 0 : memory.address;
+    if (!os.eventHandler.submitIo(kind, _fd, address, length, -1, port)) {
+      return null;
+    }
+    return channel.receive();
+  }
+
+  /**
+   * Map [length] bytes at [offset] in the file into memory, or the rest of
+   * the file if [length] is omitted. [offset] must be a multiple of the page
+   * size, and the range must be inside the file.
+   *
+   * The data is read from the file as it is accessed, instead of being
+   * copied into typed data up front. If [writable] is true, writes to the
+   * mapping go to the file, which must have been opened for writing.
+   */
+  MappedFile map({int offset: 0, int length, bool writable: false}) {
+    int fileLength = this.length;
+    if (length == null) length = fileLength - offset;
+    if (offset < 0 || length < 0 || offset + length > fileLength) {
+      throw new RangeError("Invalid offset or length.");
+    }
+    if (length == 0) {
+      return new MappedFile._(new ForeignMemory.fromAddress(0, 0), writable);
+    }
+    try {
+      var memory =
+          new MappedMemory.map(_fd, offset, length, writable: writable);
+      return new MappedFile._(memory, writable);
+    } on StateError catch (e) {
+      throw new FileException("Failed to map file '$path'");
+    }
+  }
+
   /**
    * Get the current position within the file.
    */
@@ -139,10 +226,11 @@ class File {
   }
 
   /**
-   * Flush all data written to this file.
+   * Flush all data written to this file to the disk.
    */
   void flush() {
-    // TODO(ajohnsen): Implement.
+    int result = _submit(os.IO_FSYNC, null, 0);
+    if (result != null && result < 0) _error("Failed to flush file");
   }
 
   /**
@@ -185,6 +273,19 @@ class File {
   static bool existsAsFile(String path) => sys.access(path) == 0;
 }
 
+// Memory for asynchronous operations. Unlike typed data it is not freed if
+// the process dies while the operation is running.
+class _BounceBuffer {
+  final ForeignMemory memory;
+
+  _BounceBuffer(int length) : memory = new ForeignMemory.allocated(length);
+
+  // Used by [System.memcpy].
+  ForeignMemory getForeign() => memory;
+
+  void free() => memory.free();
+}
+
 class FileException implements Exception {
   final String message;
 
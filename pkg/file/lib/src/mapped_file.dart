@@ -0,0 +1,229 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+part of file;
+
+/**
+ * A range of a file mapped into memory, see [File.map].
+ *
+ * The views returned by [asUint8List] and [asByteData] read the file
+ * directly, without copying it into typed data. They must not be used after
+ * [close] is called. If the mapping is not closed, it is unmapped once it
+ * is no longer reachable.
+ */
+class MappedFile {
+  final ForeignMemory _memory;
+  final bool isWritable;
+  bool _closed = false;
+
+  MappedFile._(this._memory, this.isWritable);
+
+  /// The number of bytes mapped.
+  int get length => _memory.length;
+
+  /// Returns true until the mapping is closed.
+  bool get isOpen => !_closed;
+
+  ByteBuffer get buffer => new _MappedByteBuffer(this);
+
+  Uint8List asUint8List([int offsetInBytes = 0, int length]) {
+    if (length == null) length = this.length - offsetInBytes;
+    _checkRange(offsetInBytes, length);
+    return new _MappedUint8List(this, offsetInBytes, length);
+  }
+
+  ByteData asByteData([int offsetInBytes = 0, int length]) {
+    if (length == null) length = this.length - offsetInBytes;
+    _checkRange(offsetInBytes, length);
+    return new _MappedByteData(this, offsetInBytes, length);
+  }
+
+  /// Unmap the file. Writes to a writable mapping have reached the file.
+  void close() {
+    _memory.free();
+    _closed = true;
+  }
+
+  void _checkRange(int offsetInBytes, int length) {
+    RangeError.checkValidRange(
+        offsetInBytes, offsetInBytes + length, this.length);
+  }
+
+  void _checkWritable() {
+    if (!isWritable) {
+      throw new UnsupportedError("Cannot modify a read-only file mapping");
+    }
+  }
+}
+
+class _MappedByteBuffer implements ByteBuffer {
+  final MappedFile _file;
+
+  _MappedByteBuffer(this._file);
+
+  // Used by the FFI based I/O in package:os, like the buffers of typed data.
+  ForeignMemory getForeign() => _file._memory;
+
+  int get lengthInBytes => _file.length;
+
+  Uint8List asUint8List([int offsetInBytes = 0, int length]) {
+    return _file.asUint8List(offsetInBytes, length);
+  }
+
+  ByteData asByteData([int offsetInBytes = 0, int length]) {
+    return _file.asByteData(offsetInBytes, length);
+  }
+
+  noSuchMethod(Invocation invocation) {
+    throw new UnsupportedError(
+        "Mapped files only support Uint8List and ByteData views");
+  }
+}
+
+class _MappedUint8List extends ListBase<int> implements Uint8List {
+  final MappedFile _file;
+  final int offsetInBytes;
+  final int length;
+
+  _MappedUint8List(this._file, this.offsetInBytes, this.length);
+
+  int operator[](int index) {
+    RangeError.checkValidIndex(index, this);
+    return _file._memory.getUint8(offsetInBytes + index);
+  }
+
+  void operator[]=(int index, int value) {
+    _file._checkWritable();
+    RangeError.checkValidIndex(index, this);
+    _file._memory.setUint8(offsetInBytes + index, value);
+  }
+
+  void set length(int value) {
+    throw new UnsupportedError("A typed data list cannot change length");
+  }
+
+  int get elementSizeInBytes => 1;
+  int get lengthInBytes => length;
+  ByteBuffer get buffer => _file.buffer;
+}
+
+class _MappedByteData implements ByteData {
+  final MappedFile _file;
+  final int offsetInBytes;
+  final int lengthInBytes;
+
+  _MappedByteData(this._file, this.offsetInBytes, this.lengthInBytes);
+
+  int get elementSizeInBytes => 1;
+  ByteBuffer get buffer => _file.buffer;
+
+  // Returns the offset of the [size] bytes at [byteOffset] in the mapping.
+  int _offset(int byteOffset, int size, Endianness endian) {
+    if (endian != Endianness.HOST_ENDIAN) {
+      throw new UnimplementedError("Only host endianness is supported");
+    }
+    RangeError.checkValidRange(
+        byteOffset, byteOffset + size, lengthInBytes);
+    return offsetInBytes + byteOffset;
+  }
+
+  int _writableOffset(int byteOffset, int size, Endianness endian) {
+    _file._checkWritable();
+    return _offset(byteOffset, size, endian);
+  }
+
+  ForeignMemory get _memory => _file._memory;
+
+  int getInt8(int byteOffset) {
+    return _memory.getInt8(_offset(byteOffset, 1, Endianness.HOST_ENDIAN));
+  }
+
+  void setInt8(int byteOffset, int value) {
+    _memory.setInt8(
+        _writableOffset(byteOffset, 1, Endianness.HOST_ENDIAN), value);
+  }
+
+  int getUint8(int byteOffset) {
+    return _memory.getUint8(_offset(byteOffset, 1, Endianness.HOST_ENDIAN));
+  }
+
+  void setUint8(int byteOffset, int value) {
+    _memory.setUint8(
+        _writableOffset(byteOffset, 1, Endianness.HOST_ENDIAN), value);
+  }
+
+  int getInt16(int byteOffset, [Endianness endian = Endianness.BIG_ENDIAN]) {
+    return _memory.getInt16(_offset(byteOffset, 2, endian));
+  }
+
+  void setInt16(int byteOffset, int value,
+                [Endianness endian = Endianness.BIG_ENDIAN]) {
+    _memory.setInt16(_writableOffset(byteOffset, 2, endian), value);
+  }
+
+  int getUint16(int byteOffset, [Endianness endian = Endianness.BIG_ENDIAN]) {
+    return _memory.getUint16(_offset(byteOffset, 2, endian));
+  }
+
+  void setUint16(int byteOffset, int value,
+                 [Endianness endian = Endianness.BIG_ENDIAN]) {
+    _memory.setUint16(_writableOffset(byteOffset, 2, endian), value);
+  }
+
+  int getInt32(int byteOffset, [Endianness endian = Endianness.BIG_ENDIAN]) {
+    return _memory.getInt32(_offset(byteOffset, 4, endian));
+  }
+
+  void setInt32(int byteOffset, int value,
+                [Endianness endian = Endianness.BIG_ENDIAN]) {
+    _memory.setInt32(_writableOffset(byteOffset, 4, endian), value);
+  }
+
+  int getUint32(int byteOffset, [Endianness endian = Endianness.BIG_ENDIAN]) {
+    return _memory.getUint32(_offset(byteOffset, 4, endian));
+  }
+
+  void setUint32(int byteOffset, int value,
+                 [Endianness endian = Endianness.BIG_ENDIAN]) {
+    _memory.setUint32(_writableOffset(byteOffset, 4, endian), value);
+  }
+
+  int getInt64(int byteOffset, [Endianness endian = Endianness.BIG_ENDIAN]) {
+    return _memory.getInt64(_offset(byteOffset, 8, endian));
+  }
+
+  void setInt64(int byteOffset, int value,
+                [Endianness endian = Endianness.BIG_ENDIAN]) {
+    _memory.setInt64(_writableOffset(byteOffset, 8, endian), value);
+  }
+
+  int getUint64(int byteOffset, [Endianness endian = Endianness.BIG_ENDIAN]) {
+    return _memory.getUint64(_offset(byteOffset, 8, endian));
+  }
+
+  void setUint64(int byteOffset, int value,
+                 [Endianness endian = Endianness.BIG_ENDIAN]) {
+    _memory.setUint64(_writableOffset(byteOffset, 8, endian), value);
+  }
+
+  double getFloat32(int byteOffset,
+                    [Endianness endian = Endianness.BIG_ENDIAN]) {
+    return _memory.getFloat32(_offset(byteOffset, 4, endian));
+  }
+
+  void setFloat32(int byteOffset, double value,
+                  [Endianness endian = Endianness.BIG_ENDIAN]) {
+    _memory.setFloat32(_writableOffset(byteOffset, 4, endian), value);
+  }
+
+  double getFloat64(int byteOffset,
+                    [Endianness endian = Endianness.BIG_ENDIAN]) {
+    return _memory.getFloat64(_offset(byteOffset, 8, endian));
+  }
+
+  void setFloat64(int byteOffset, double value,
+                  [Endianness endian = Endianness.BIG_ENDIAN]) {
+    _memory.setFloat64(_writableOffset(byteOffset, 8, endian), value);
+  }
+}
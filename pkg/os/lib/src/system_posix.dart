@@ -24,10 +24,6 @@ abstract class PosixSystem implements System {
       ForeignLibrary.main.lookup("connect");
   static final ForeignFunction _fcntl =
       ForeignLibrary.main.lookup("fcntl");
-  static final ForeignFunction _freeaddrinfo =
-      ForeignLibrary.main.lookup("freeaddrinfo");
-  static final ForeignFunction _getaddrinfo =
-      ForeignLibrary.main.lookup("getaddrinfo");
   static final ForeignFunction _getsockname =
       ForeignLibrary.main.lookup("getsockname");
   static final ForeignFunction _ioctl =
@@ -97,43 +93,13 @@ abstract class PosixSystem implements System {
   }
 
   InternetAddress lookup(String host) {
-    ForeignMemory node = new ForeignMemory.fromStringAsUTF8(host);
-    // TODO(ajohnsen): Actually apply hints.
-    AddrInfo hints = new AddrInfo();
     // TODO(ajohnsen): Allow IPv6 results.
-    hints.family = AF_INET;
-    Struct result = new Struct(1);
-    int status = _getaddrinfo.icall$4Retry(
-        node, ForeignPointer.NULL, hints, result);
-    AddrInfo start = new AddrInfo.fromAddress(result.getField(0));
-    AddrInfo info = start;
-    var address;
-    while (info.address != 0) {
-      int length;
-      int offset;
-      // Loop until we find the right type.
-      if (info.family == AF_INET) {
-        length = 4;
-        offset = 4;
-      } else if (info.family == AF_INET6) {
-        length = 16;
-        offset = 8;
-      } else {
-        info = info.next;
-        continue;
-      }
-      ForeignMemory addr = info.addr;
-      List<int> bytes = new List<int>(length);
-      addr.copyBytesToList(bytes, offset, offset + length, 0);
-      address = new _InternetAddress(bytes);
-      break;
+    int address = os.HostResolver.lookupIPv4(host);
+    if (address < 0) {
+      throw "Failed to resolve '$host': getaddrinfo error ${-address}";
     }
-    _freeaddrinfo.icall$1Retry(start);
-    node.free();
-    hints.free();
-    result.free();
-    if (status != 0) throw "Failed to call 'getaddrinfo': ${errno()}";
-    return address;
+    return new _InternetAddress([(address >> 24) & 0xff, (address >> 16) & 0xff,
+                                 (address >> 8) & 0xff, address & 0xff]);
   }
 
   int open(String path, bool read, bool write, bool append) {
@@ -26,6 +26,11 @@ class _SocketBase {
   int _fd = -1;
   Channel _channel;
   Port _port;
+  // The persistent event registration of [_fd], if any.
+  os.EventRegistration _registration;
+  // The registration of [_fd] if the VM buffers its data, see
+  // [os.EventHandler.openStream].
+  os.SocketStream _stream;
 
   _SocketBase() {
     _channel = new Channel();
@@ -33,16 +38,34 @@ class _SocketBase {
   }
 
   int _waitFor(int mask) {
+    if (_registration != null) {
+      while (true) {
+        int events = _registration.wait(mask);
+        if (events == 0) events = _channel.receive();
+        if (events != 0) return events;
+      }
+    }
     os.eventHandler.registerPortForNextEvent(_fd, _port, mask);
     return _channel.receive();
   }
 
+  // Events of a persistent registration can be stale, in which case the
+  // operation fails with EAGAIN and has to wait again.
+  bool get _wouldBlock {
+    return _registration != null && sys.errno() == errnos.EAGAIN;
+  }
+
   /**
    * Close the socket. Operations on the socket are invalid after a call to
    * [close].
    */
   void close() {
     if (_fd != -1) {
+      if (_registration != null) {
+        _registration.unregister();
+        _registration = null;
+        _stream = null;
+      }
       // If there is an error before we initialize the event handling,
       // [_port] and [_channel] are `null`.
       if (_port != null) {
@@ -56,6 +79,7 @@ class _SocketBase {
 
   /// Get the number of available bytes.
   int get available {
+    if (_stream != null) return _stream.available;
     int value = sys.available(_fd);
     if (value == -1) {
       _error("Failed to get the number of available bytes");
@@ -72,22 +96,33 @@ class _SocketBase {
 class Socket extends _SocketBase {
   /**
    * Connect to the endpoint '[host]:[port]'.
+   *
+   * If [persistent] is true, the socket registers with the event handler
+   * once, instead of once for every operation that has to wait. Readiness
+   * is then tracked by the VM and waiting for data that already arrived
+   * costs no system call. Only supported on Linux, ignored elsewhere.
+   *
+   * If [buffered] is true, the socket is registered persistently and the
+   * VM also reads the received data into a buffer as soon as it arrives,
+   * so reading takes no system call either. Only supported on Linux.
    */
-  factory Socket.connect(String host, int port) {
+  factory Socket.connect(String host, int port,
+                         {bool persistent: false, bool buffered: false}) {
     if (Foreign.platform == Foreign.FREERTOS) {
       return new stm32.Socket.connect(host, port);
     } else {
-      return new Socket._connect(host, port);
+      return new Socket._connect(host, port, persistent, buffered);
     }
   }
 
-  Socket._connect(String host, int port) {
+  Socket._connect(String host, int port, bool persistent, bool buffered) {
     var address = sys.lookup(host);
     if (address == null) _error("Failed to lookup address '$host'");
     _fd = sys.socket(sys.AF_INET, sys.SOCK_STREAM, 0);
     if (_fd == -1) _error("Failed to create socket");
     sys.setBlocking(_fd, false);
     sys.setCloseOnExec(_fd, true);
+    if (persistent || buffered) _registerPersistently(buffered);
     if (sys.connect(_fd, address, port) == -1 &&
         sys.errno() != errnos.EINPROGRESS) {
       _error("Failed to connect to $host:$port");
@@ -98,9 +133,27 @@ class Socket extends _SocketBase {
     }
   }
 
-  Socket._fromFd(fd) {
+  Socket._fromFd(fd, bool persistent, bool buffered) {
     // Be sure it's not in the event handler.
     _fd = fd;
+    if (persistent || buffered) _registerPersistently(buffered);
+  }
+
+  // Register with the event handler once, instead of once for every
+  // operation that has to wait. Only supported on Linux.
+  void _registerPersistently(bool buffered) {
+    if (Foreign.platform != Foreign.LINUX) return;
+    if (buffered) {
+      _registration = _stream = os.eventHandler.openStream(_fd, _port);
+    } else {
+      _registration = os.eventHandler.register(_fd, _port);
+    }
+  }
+
+  static int _address(ByteBuffer buffer) {
+    // Dartino's byte buffers are backed by foreign memory.
+    var b = buffer;
+    return b.getForeign().address;
   }
 
   /**
@@ -110,12 +163,16 @@ class Socket extends _SocketBase {
    */
   ByteBuffer read(int bytes) {
     ByteBuffer buffer = new Uint8List(bytes).buffer;
+    if (_stream != null) return _readBuffered(buffer) ? buffer : null;
     int offset = 0;
     while (offset < bytes) {
       int events = _waitFor(os.READ_EVENT);
       int read = 0;
       if ((events & os.READ_EVENT) != 0) {
         read = sys.read(_fd, buffer, offset, bytes - offset);
+        if (read == -1 && _wouldBlock) continue;
+        // More data may be available, which would not be reported again.
+        if (read == bytes - offset) _markReadable();
       }
       if (read == 0 || (events & os.CLOSE_EVENT) != 0) {
         if (offset + read < bytes) return null;
@@ -128,24 +185,56 @@ class Socket extends _SocketBase {
     return buffer;
   }
 
+  // Fills [buffer] from the stream. Returns false if the socket was closed
+  // before.
+  bool _readBuffered(ByteBuffer buffer) {
+    int address = _address(buffer);
+    int bytes = buffer.lengthInBytes;
+    int offset = 0;
+    while (offset < bytes) {
+      offset += _stream.read(address + offset, bytes - offset);
+      if (offset == bytes) break;
+      // Reading from a full ring refills it.
+      if (_stream.available > 0) continue;
+      int events = _waitFor(os.READ_EVENT);
+      // Data received before a close or an error is still read.
+      if ((events & os.READ_EVENT) != 0 || _stream.available > 0) continue;
+      if ((events & os.ERROR_EVENT) != 0) _error("Failed to read from socket");
+      if ((events & os.CLOSE_EVENT) != 0) return false;
+    }
+    // Keep reporting the rest of the buffered data.
+    if (_stream.available > 0) _markReadable();
+    return true;
+  }
+
   /**
    * Read the next chunk of bytes.
    * Will block until some bytes are available.
    * Returns `null` if the socket was closed for reading.
    */
   ByteBuffer readNext([int max]) {
-    int events = _waitFor(os.READ_EVENT);
-    int read = 0;
+    if (_stream != null) return _readNextBuffered(max);
+    int events;
+    int read;
     ByteBuffer buffer;
-    if ((events & os.READ_EVENT) != 0) {
-      int available = this.available;
-      int maxRead = available;
-      if (max != null) {
-        maxRead = max < available ? max : available;
+    do {
+      events = _waitFor(os.READ_EVENT);
+      read = 0;
+      if ((events & os.READ_EVENT) != 0) {
+        int available = this.available;
+        int maxRead = available;
+        if (max != null) {
+          maxRead = max < available ? max : available;
+        }
+        buffer = new Uint8List(maxRead).buffer;
+        read = sys.read(_fd, buffer, 0, maxRead);
+        if (read == -1 && _wouldBlock) read = 0;
+        if (read < available) _markReadable();
       }
-      buffer = new Uint8List(maxRead).buffer;
-      read = sys.read(_fd, buffer, 0, maxRead);
-    }
+      // A stale event of a persistent registration finds no data.
+    } while (_registration != null &&
+             read == 0 &&
+             (events & (os.CLOSE_EVENT | os.ERROR_EVENT)) == 0);
     if (read == 0 && (events & os.CLOSE_EVENT) != 0) return null;
     if (read < 0 || (events & os.ERROR_EVENT) != 0) {
       _error("Failed to read from socket");
@@ -153,16 +242,35 @@ class Socket extends _SocketBase {
     return buffer;
   }
 
+  ByteBuffer _readNextBuffered(int max) {
+    while (_stream.available == 0) {
+      int events = _waitFor(os.READ_EVENT);
+      if (_stream.available > 0) break;
+      if ((events & os.ERROR_EVENT) != 0) _error("Failed to read from socket");
+      if ((events & os.CLOSE_EVENT) != 0) return null;
+    }
+    int available = _stream.available;
+    int bytes = (max != null && max < available) ? max : available;
+    ByteBuffer buffer = new Uint8List(bytes).buffer;
+    _readBuffered(buffer);
+    return buffer;
+  }
+
   /**
    * Write [buffer] on the socket. Will block until all of [buffer] is written.
    */
   void write(ByteBuffer buffer) {
+    if (_stream != null) {
+      writeAll([buffer]);
+      return;
+    }
     int offset = 0;
     int bytes = buffer.lengthInBytes;
     while (true) {
       int wrote = sys.write(_fd, buffer, offset, bytes - offset);
       if (wrote == -1) {
-        _error("Failed to write to socket");
+        if (!_wouldBlock) _error("Failed to write to socket");
+        wrote = 0;
       }
       offset += wrote;
       if (offset == bytes) return;
@@ -173,6 +281,107 @@ class Socket extends _SocketBase {
     }
   }
 
+  /**
+   * Write all of [buffers] on the socket, in order. Will block until all of
+   * them are written.
+   *
+   * Sockets created with `buffered: true` write up to
+   * [os.SocketStream.MAX_BUFFERS] buffers with a single system call.
+   */
+  void writeAll(List<ByteBuffer> buffers) {
+    if (_stream == null) {
+      buffers.forEach(write);
+      return;
+    }
+    List<int> addresses = new List<int>();
+    List<int> lengths = new List<int>();
+    int next = 0;
+    while (true) {
+      while (next < buffers.length &&
+             addresses.length < os.SocketStream.MAX_BUFFERS) {
+        ByteBuffer buffer = buffers[next++];
+        if (buffer.lengthInBytes == 0) continue;
+        addresses.add(_address(buffer));
+        lengths.add(buffer.lengthInBytes);
+      }
+      if (addresses.isEmpty) return;
+      int wrote = _stream.write(addresses, lengths);
+      if (wrote < 0) {
+        if (-wrote != errnos.EAGAIN) {
+          close();
+          throw new SocketException("Failed to write to socket", -wrote);
+        }
+        int events = _waitFor(os.WRITE_EVENT);
+        if ((events & os.ERROR_EVENT) != 0) {
+          _error("Failed to write to socket");
+        }
+        continue;
+      }
+      // Drop the buffers that were written and advance into the first one
+      // that was written partially.
+      int done = 0;
+      while (done < lengths.length && wrote >= lengths[done]) {
+        wrote -= lengths[done++];
+      }
+      addresses.removeRange(0, done);
+      lengths.removeRange(0, done);
+      if (wrote > 0) {
+        addresses[0] += wrote;
+        lengths[0] -= wrote;
+      }
+    }
+  }
+
+  /**
+   * Send [length] bytes at [offset] in the file with the descriptor [fd],
+   * e.g. a `File.fd`, on the socket. Will block until they are sent or the
+   * file ends. Returns the number of bytes sent.
+   *
+   * Where the platform supports it, the VM transfers the data without
+   * copying it into the heap. Sockets with a persistent registration copy
+   * it through a buffer instead.
+   */
+  int sendFile(int fd, int offset, int length) {
+    if (_registration == null &&
+        os.eventHandler.sendFile(_fd, fd, offset, length, _port)) {
+      int result = _channel.receive();
+      if (result < 0) {
+        close();
+        throw new SocketException("Failed to send file", -result);
+      }
+      return result;
+    }
+    return _copyFile(fd, offset, length);
+  }
+
+  static const int _COPY_CHUNK_SIZE = 64 * 1024;
+
+  int _copyFile(int fd, int offset, int length) {
+    if (sys.lseek(fd, offset, SEEK_SET) != offset) {
+      _error("Failed to seek in file");
+    }
+    int size = length < _COPY_CHUNK_SIZE ? length : _COPY_CHUNK_SIZE;
+    ByteBuffer buffer = new Uint8List(size).buffer;
+    int sent = 0;
+    while (sent < length) {
+      int bytes = length - sent < size ? length - sent : size;
+      int read = sys.read(fd, buffer, 0, bytes);
+      if (read == -1) _error("Failed to read from file");
+      if (read == 0) break;
+      if (read == size) {
+        write(buffer);
+      } else {
+        write(new Uint8List.fromList(buffer.asUint8List(0, read)).buffer);
+      }
+      sent += read;
+    }
+    return sent;
+  }
+
+  void _markReadable() {
+    if (_registration != null) _registration.markReady(os.READ_EVENT);
+  }
+
   /**
    * Close the socket for writing. After the socket is closed for writing,
    * [write] to the socket will fail.
@@ -185,12 +394,25 @@ class Socket extends _SocketBase {
 }
 
 class ServerSocket extends _SocketBase {
+  // Whether accepted sockets use persistent event registrations.
+  final bool _persistent;
+  // Whether the VM buffers the data received on accepted sockets.
+  final bool _buffered;
+
   /**
    * Create a new server socket, listening on '[host]:[port]'.
    *
    * If [port] is '0', a random free port will be selected for the socket.
+   *
+   * If [persistent] is true, accepted sockets register with the event
+   * handler once instead of for every operation that has to wait, see
+   * [Socket.connect]. If [buffered] is true, the VM also buffers the data
+   * they receive.
    */
-  ServerSocket(String host, int port) {
+  ServerSocket(String host, int port,
+               {bool persistent: false, bool buffered: false})
+      : _persistent = persistent,
+        _buffered = buffered {
     var address = sys.lookup(host);
     if (address == null) _error("Failed to lookup address '$host'");
     _fd = sys.socket(sys.AF_INET, sys.SOCK_STREAM, 0);
@@ -238,7 +460,10 @@ class ServerSocket extends _SocketBase {
     }
 
     int client = _accept();
-    return Process.spawnDetached(() => fn(new Socket._fromFd(client)));
+    bool persistent = _persistent;
+    bool buffered = _buffered;
+    return Process.spawnDetached(
+        () => fn(new Socket._fromFd(client, persistent, buffered)));
   }
 
   /**
@@ -246,7 +471,7 @@ class ServerSocket extends _SocketBase {
    * accepted.
    */
   Socket accept() {
-    return new Socket._fromFd(_accept());
+    return new Socket._fromFd(_accept(), _persistent, _buffered);
   }
 
   int _accept() {
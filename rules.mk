@@ -27,6 +27,10 @@ DARTINO_SRC_FLASHTOOL := $(DARTINO_ROOT)/src/tools/flashtool
 # to build the flashtool helper. So as long as flashtool still builds in
 # a crosscompilation setting it does not matter where a new file goes.
 DARTINO_SRC_VM_SRCS_RUNTIME := \
+	$(DARTINO_SRC_VM)/blocking_call_pool.cc \
+	$(DARTINO_SRC_VM)/blocking_call_pool.h \
+	$(DARTINO_SRC_VM)/bytecode_profiler.cc \
+	$(DARTINO_SRC_VM)/bytecode_profiler.h \
 	$(DARTINO_SRC_VM)/dartino_api_impl.cc \
 	$(DARTINO_SRC_VM)/dartino_api_impl.h \
 	$(DARTINO_SRC_VM)/dartino.cc \
@@ -45,6 +49,8 @@ DARTINO_SRC_VM_SRCS_RUNTIME := \
 	$(DARTINO_SRC_VM)/event_handler_macos.cc \
 	$(DARTINO_SRC_VM)/event_handler_posix.cc \
 	$(DARTINO_SRC_VM)/event_handler_windows.cc \
+	$(DARTINO_SRC_VM)/file_transfer.cc \
+	$(DARTINO_SRC_VM)/file_transfer.h \
 	$(DARTINO_SRC_VM)/gc_metadata.cc \
 	$(DARTINO_SRC_VM)/gc_metadata.h \
 	$(DARTINO_SRC_VM)/hash_map.h \
@@ -77,6 +83,8 @@ DARTINO_SRC_VM_SRCS_RUNTIME := \
 	$(DARTINO_SRC_VM)/natives_windows.cc \
 	$(DARTINO_SRC_VM)/object.cc \
 	$(DARTINO_SRC_VM)/object.h \
+	$(DARTINO_SRC_VM)/object_graph_copier.cc \
+	$(DARTINO_SRC_VM)/object_graph_copier.h \
 	$(DARTINO_SRC_VM)/object_list.cc \
 	$(DARTINO_SRC_VM)/object_list.h \
 	$(DARTINO_SRC_VM)/object_map.cc \
@@ -95,6 +103,8 @@ DARTINO_SRC_VM_SRCS_RUNTIME := \
 	$(DARTINO_SRC_VM)/process_handle.h \
 	$(DARTINO_SRC_VM)/process_queue.h \
 	$(DARTINO_SRC_VM)/program.cc \
+	$(DARTINO_SRC_VM)/program_channel.cc \
+	$(DARTINO_SRC_VM)/program_channel.h \
 	$(DARTINO_SRC_VM)/program_folder.cc \
 	$(DARTINO_SRC_VM)/program_folder.h \
 	$(DARTINO_SRC_VM)/program_folder_no_live_coding.h \
@@ -103,6 +113,8 @@ DARTINO_SRC_VM_SRCS_RUNTIME := \
 	$(DARTINO_SRC_VM)/program.h \
 	$(DARTINO_SRC_VM)/program_info_block.cc \
 	$(DARTINO_SRC_VM)/program_info_block.h \
+	$(DARTINO_SRC_VM)/resolver.cc \
+	$(DARTINO_SRC_VM)/resolver.h \
 	$(DARTINO_SRC_VM)/scheduler.cc \
 	$(DARTINO_SRC_VM)/scheduler.h \
 	$(DARTINO_SRC_VM)/selector_row.cc \
@@ -115,6 +127,8 @@ DARTINO_SRC_VM_SRCS_RUNTIME := \
 	$(DARTINO_SRC_VM)/signal.h \
 	$(DARTINO_SRC_VM)/snapshot.cc \
 	$(DARTINO_SRC_VM)/snapshot.h \
+	$(DARTINO_SRC_VM)/socket_stream.cc \
+	$(DARTINO_SRC_VM)/socket_stream.h \
 	$(DARTINO_SRC_VM)/sort.cc \
 	$(DARTINO_SRC_VM)/sort.h \
 	$(DARTINO_SRC_VM)/thread_cmsis.cc \
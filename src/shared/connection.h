@@ -104,6 +104,9 @@ class Connection {
     kProcessGetProcessIds,
     kProcessGetProcessIdsResult,
 
+    kBytecodeProfile,
+    kBytecodeProfileResult,
+
     kSetEntryPoint,
     kCreateSnapshot,
     kProgramInfo,
@@ -56,6 +56,26 @@ namespace dartino {
                "Collect execution time sampels of the entire VM")         \
   FLAG_CSTRING(release, tick_file, "dartino.ticks",                       \
                "Write tick samples in this file")                         \
+  FLAG_BOOLEAN(release, profile_bytecodes, false,                         \
+               "Count executed bytecodes, bytecode pairs and functions")  \
+  FLAG_CSTRING(release, bytecode_profile_file, "dartino.bcprofile",       \
+               "Write the bytecode profile to this file at exit")         \
+  FLAG_INTEGER(release, handoff_limit, 16,                                \
+               "Max processes a worker parks after handing over to the "  \
+               "receiver of a message before using the ready queue")     \
+  FLAG_INTEGER(release, idle_spin_count, 1000,                            \
+               "Max polls of the ready queue before a worker sleeps")     \
+  FLAG_INTEGER(release, event_handler_shards, 1,                          \
+               "Number of event handler threads file descriptors and "    \
+               "timeouts are spread over")                                \
+  FLAG_BOOLEAN(release, io_uring, true,                                   \
+               "Use io_uring for asynchronous I/O if the kernel has it")  \
+  FLAG_INTEGER(release, blocking_call_threads, 8,                         \
+               "Max threads running blocking foreign calls")              \
+  FLAG_INTEGER(release, resolver_ttl, 60,                                 \
+               "Seconds host name lookups are cached")                    \
+  FLAG_INTEGER(release, resolver_negative_ttl, 5,                         \
+               "Seconds failed host name lookups are cached")             \
   /* Temporary compiler flags */                                          \
   FLAG_BOOLEAN(release, trace_compiler, false, "")                        \
   FLAG_BOOLEAN(release, trace_library, false, "")
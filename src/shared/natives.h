@@ -131,6 +131,7 @@ namespace dartino {
                                                                                \
   N(ProcessSpawn, "Process", "_spawn", true)                                   \
   N(ProcessQueueGetMessage, "Process", "_queueGetMessage", true)               \
+  N(ProcessQueueGetMessages, "Process", "_queueGetMessages", true)             \
   N(ProcessQueueSetupProcessDeath, "Process", "_queueSetupProcessDeath",       \
     false)                                                                     \
   N(ProcessQueueGetChannel, "Process", "_queueGetChannel", true)               \
@@ -138,6 +139,7 @@ namespace dartino {
                                                                                \
   N(CoroutineCurrent, "Coroutine", "_coroutineCurrent", true)                  \
   N(CoroutineNewStack, "Coroutine", "_coroutineNewStack", true)                \
+  N(CoroutineRecycleStack, "Coroutine", "_coroutineRecycleStack", true)        \
                                                                                \
   N(StopwatchFrequency, "Stopwatch", "_frequency", true)                       \
   N(StopwatchNow, "Stopwatch", "_now", true)                                   \
@@ -152,6 +154,7 @@ namespace dartino {
   N(ForeignBitsPerWord, "Foreign", "_bitsPerMachineWord", true)                \
   N(ForeignBitsPerDouble, "Foreign", "_bitsPerDouble", true)                   \
   N(ForeignErrno, "Foreign", "_errno", true)                                   \
+  N(ForeignSetErrno, "Foreign", "_setErrno", true)                             \
   N(ForeignPlatform, "Foreign", "_platform", true)                             \
   N(ForeignArchitecture, "Foreign", "_architecture", true)                     \
   N(ForeignConvertPort, "ForeignConversion", "convertPort", true)              \
@@ -187,6 +190,8 @@ namespace dartino {
                                                                                \
   N(ForeignLCallwLw, "ForeignFunction", "_Lcall$wLw", false)                   \
                                                                                \
+  N(ForeignBlockingCall, "_BlockingForeignFunction", "_submit", true)          \
+                                                                               \
   N(ForeignRegisterFinalizer, "Foreign", "_registerFinalizer", true)           \
   N(ForeignRemoveFinalizer, "Foreign", "_removeFinalizer", true)               \
                                                                                \
@@ -226,6 +231,9 @@ namespace dartino {
   N(ForeignSetFloat64, "UnsafeMemory", "_setFloat64", true)                    \
                                                                                \
   N(ForeignFree, "ForeignMemory", "_free", true)                               \
+  N(ForeignMapFile, "MappedMemory", "_map", true)                              \
+  N(ForeignMarkMapped, "MappedMemory", "_markForUnmapping", false)             \
+  N(ForeignUnmap, "MappedMemory", "_unmap", false)                             \
                                                                                \
   N(StringLength, "_StringBase", "length", true)                               \
                                                                                \
@@ -255,9 +263,40 @@ namespace dartino {
                                                                                \
   N(PortCreate, "Port", "_create", true)                                       \
   N(PortSend, "Port", "send", true)                                            \
+  N(PortSendList, "Port", "_sendList", true)                                   \
   N(PortSendExit, "Port", "_sendExit", true)                                   \
+  N(PortSendCopy, "Port", "sendCopy", true)                                    \
+  N(PortTransfer, "Port", "transfer", true)                                    \
+  N(PortSetCapacity, "Port", "_setCapacity", true)                             \
+  N(PortCapacity, "Port", "capacity", true)                                    \
+  N(PortOverflow, "Port", "_overflow", true)                                   \
+  N(PortQueueLength, "Port", "queueLength", true)                              \
+  N(ProgramChannelOpen, "ProgramChannel", "_open", false)                      \
+  N(ProgramChannelClose, "ProgramChannel", "_close", true)                     \
+  N(ProgramChannelSend, "ProgramChannel", "_send", true)                       \
+  N(ProgramChannelNextSize, "ProgramChannel", "_nextSize", true)               \
+  N(ProgramChannelReceive, "ProgramChannel", "_receive", true)                 \
+  N(ProgramChannelWait, "ProgramChannel", "_wait", true)                       \
                                                                                \
   N(SystemEventHandlerAdd, "EventHandler", "_eventHandlerAdd", true)           \
+  N(SystemEventHandlerRegister, "EventHandler", "_eventHandlerRegister", true) \
+  N(SystemEventHandlerWait, "EventHandler", "_eventHandlerWait", true)         \
+  N(SystemEventHandlerMarkReady, "EventHandler", "_eventHandlerMarkReady",     \
+    true)                                                                      \
+  N(SystemEventHandlerUnregister, "EventHandler", "_eventHandlerUnregister",   \
+    true)                                                                      \
+  N(SystemEventHandlerSubmitIo, "EventHandler", "_eventHandlerSubmitIo",       \
+    true)                                                                      \
+  N(SystemEventHandlerSendFile, "EventHandler", "_eventHandlerSendFile",       \
+    true)                                                                      \
+  N(SystemResolverLookup, "HostResolver", "_lookup", true)                     \
+                                                                               \
+  N(SocketStreamOpen, "SocketStream", "_open", true)                           \
+  N(SocketStreamBuffer, "SocketStream", "_buffer", true)                       \
+  N(SocketStreamAvailable, "SocketStream", "_available", true)                 \
+  N(SocketStreamRead, "SocketStream", "_read", true)                           \
+  N(SocketStreamConsume, "SocketStream", "_consume", true)                     \
+  N(SocketStreamWrite, "SocketStream", "_write", true)                         \
                                                                                \
   N(ServiceRegister, "<none>", "register", true)                               \
                                                                                \
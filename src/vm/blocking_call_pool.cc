@@ -0,0 +1,178 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/blocking_call_pool.h"
+
+#include <errno.h>
+
+#include "src/shared/flags.h"
+#include "src/shared/utils.h"
+#include "src/vm/event_handler.h"
+#include "src/vm/port.h"
+
+#if defined(DARTINO_TARGET_OS_WIN)
+#include <windows.h>
+#endif
+
+namespace dartino {
+
+typedef int (*F0)();
+typedef int (*F1)(word);
+typedef int (*F2)(word, word);
+typedef int (*F3)(word, word, word);
+typedef int (*F4)(word, word, word, word);
+typedef int (*F5)(word, word, word, word, word);
+typedef int (*F6)(word, word, word, word, word, word);
+typedef int (*F7)(word, word, word, word, word, word, word);
+
+typedef word (*PF7)(word, word, word, word, word, word, word);
+
+// The error code read by Foreign.errno, see ForeignErrno.
+static int LastError() {
+#if defined(DARTINO_TARGET_OS_WIN)
+  return GetLastError();
+#else
+  return errno;
+#endif
+}
+
+BlockingCall::BlockingCall(Kind kind, word address, int argc,
+                           word* arguments, Port* port)
+    : kind_(kind), address_(address), argc_(argc), port_(port) {
+  ASSERT(argc >= 0 && argc <= kMaxArguments);
+  for (int i = 0; i < kMaxArguments; i++) {
+    arguments_[i] = i < argc ? arguments[i] : 0;
+  }
+  port_->IncrementRef();
+}
+
+BlockingCall::~BlockingCall() { port_->DecrementRef(); }
+
+int64 BlockingCall::Call() {
+  word* a = arguments_;
+  if (kind_ != INT) {
+    // Passing unused arguments is harmless with the C calling conventions,
+    // so pointer and void functions all go through the widest signature.
+    PF7 function = reinterpret_cast<PF7>(address_);
+    return function(a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+  }
+  // The result is an int, so its upper bits are only defined if the
+  // function is called through the matching signature.
+  switch (argc_) {
+    case 0:
+      return reinterpret_cast<F0>(address_)();
+    case 1:
+      return reinterpret_cast<F1>(address_)(a[0]);
+    case 2:
+      return reinterpret_cast<F2>(address_)(a[0], a[1]);
+    case 3:
+      return reinterpret_cast<F3>(address_)(a[0], a[1], a[2]);
+    case 4:
+      return reinterpret_cast<F4>(address_)(a[0], a[1], a[2], a[3]);
+    case 5:
+      return reinterpret_cast<F5>(address_)(a[0], a[1], a[2], a[3], a[4]);
+    case 6:
+      return reinterpret_cast<F6>(address_)(a[0], a[1], a[2], a[3], a[4],
+                                            a[5]);
+    default:
+      return reinterpret_cast<F7>(address_)(a[0], a[1], a[2], a[3], a[4],
+                                            a[5], a[6]);
+  }
+}
+
+void BlockingCall::Perform() {
+  int64 result = Call();
+  int error = LastError();
+  if (kind_ == VOID) result = 0;
+  EventHandler::Send(port_, error, false);
+  EventHandler::Send(port_, result, false);
+}
+
+BlockingCallPool* BlockingCallPool::instance_ = NULL;
+
+void BlockingCallPool::Setup() {
+  ASSERT(instance_ == NULL);
+  instance_ = new BlockingCallPool();
+}
+
+void BlockingCallPool::TearDown() {
+  ASSERT(instance_ != NULL);
+  BlockingCallPool* pool = instance_;
+  instance_ = NULL;
+  bool busy;
+  {
+    ScopedMonitorLock locker(pool->monitor_);
+    pool->shutdown_ = true;
+    while (pool->head_ != NULL) {
+      BlockingTask* task = pool->head_;
+      pool->head_ = task->next();
+      delete task;
+    }
+    pool->tail_ = NULL;
+    busy = pool->idle_ < pool->threads_;
+    pool->monitor_->NotifyAll();
+  }
+  // A thread may be stuck in a call that never returns. It still uses the
+  // pool when it does, so the pool is leaked rather than waiting for it.
+  if (busy) return;
+  pool->thread_pool_.JoinAll();
+  delete pool;
+}
+
+BlockingCallPool::BlockingCallPool()
+    : monitor_(Platform::CreateMonitor()),
+      thread_pool_(Utils::Maximum(1, Flags::blocking_call_threads)),
+      head_(NULL),
+      tail_(NULL),
+      threads_(0),
+      idle_(0),
+      shutdown_(false) {
+  thread_pool_.Start();
+}
+
+BlockingCallPool::~BlockingCallPool() { delete monitor_; }
+
+void BlockingCallPool::Submit(BlockingTask* task) {
+  ScopedMonitorLock locker(monitor_);
+  ASSERT(!shutdown_);
+  if (tail_ == NULL) {
+    head_ = task;
+  } else {
+    tail_->set_next(task);
+  }
+  tail_ = task;
+  if (idle_ > 0) {
+    monitor_->Notify();
+  } else if (threads_ < thread_pool_.max_threads()) {
+    threads_++;
+    while (!thread_pool_.TryStartThread(RunThread, this)) {
+    }
+  }
+}
+
+void BlockingCallPool::RunThread(void* data) {
+  reinterpret_cast<BlockingCallPool*>(data)->Run();
+}
+
+void BlockingCallPool::Run() {
+  ScopedMonitorLock locker(monitor_);
+  while (true) {
+    while (head_ == NULL && !shutdown_) {
+      idle_++;
+      monitor_->Wait();
+      idle_--;
+    }
+    if (head_ == NULL) return;
+    BlockingTask* task = head_;
+    head_ = task->next();
+    if (head_ == NULL) tail_ = NULL;
+    {
+      ScopedMonitorUnlock unlocker(monitor_);
+      task->Perform();
+      delete task;
+    }
+  }
+}
+
+}  // namespace dartino
@@ -0,0 +1,98 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_BLOCKING_CALL_POOL_H_
+#define SRC_VM_BLOCKING_CALL_POOL_H_
+
+#include "src/shared/globals.h"
+#include "src/shared/platform.h"
+#include "src/vm/thread_pool.h"
+
+namespace dartino {
+
+class Port;
+
+// Work that may block for a long time, run on the BlockingCallPool.
+class BlockingTask {
+ public:
+  BlockingTask() : next_(NULL) {}
+  virtual ~BlockingTask() {}
+
+  virtual void Perform() = 0;
+
+  BlockingTask* next() const { return next_; }
+  void set_next(BlockingTask* next) { next_ = next; }
+
+ private:
+  BlockingTask* next_;
+};
+
+// A call to a foreign function with up to kMaxArguments word arguments.
+// The caller is suspended while the call runs on a thread of the
+// BlockingCallPool. The errno after the call and then the result are sent
+// to the port.
+class BlockingCall : public BlockingTask {
+ public:
+  enum Kind {
+    INT,
+    POINTER,
+    VOID,
+    NUMBER_OF_KINDS,
+  };
+
+  static const int kMaxArguments = 7;
+
+  BlockingCall(Kind kind, word address, int argc, word* arguments,
+               Port* port);
+  ~BlockingCall();
+
+  // Calls the function on the current thread and sends the result.
+  void Perform();
+
+ private:
+  int64 Call();
+
+  const Kind kind_;
+  const word address_;
+  const int argc_;
+  word arguments_[kMaxArguments];
+  Port* const port_;
+};
+
+// Threads running blocking foreign calls and other blocking tasks, so they
+// do not hold up the worker threads interpreting Dart code. Threads are
+// started on demand, up to Flags::blocking_call_threads, and stay around
+// once started.
+class BlockingCallPool {
+ public:
+  static void Setup();
+  static void TearDown();
+
+  static BlockingCallPool* GlobalInstance() { return instance_; }
+
+  // Queues [task] and takes ownership of it.
+  void Submit(BlockingTask* task);
+
+ private:
+  BlockingCallPool();
+  ~BlockingCallPool();
+
+  static void RunThread(void* data);
+  void Run();
+
+  static BlockingCallPool* instance_;
+
+  Monitor* monitor_;
+  ThreadPool thread_pool_;
+  BlockingTask* head_;
+  BlockingTask* tail_;
+  int threads_;
+  // The number of threads waiting for a task.
+  int idle_;
+  bool shutdown_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_BLOCKING_CALL_POOL_H_
@@ -0,0 +1,248 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/bytecode_profiler.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "src/shared/connection.h"
+#include "src/shared/flags.h"
+#include "src/shared/platform.h"
+#include "src/shared/utils.h"
+
+#include "src/vm/object.h"
+#include "src/vm/process.h"
+#include "src/vm/program.h"
+
+namespace dartino {
+
+// Bytecodes are never executed past the method end marker, so it doubles as
+// the "no previous bytecode" value for the pair counts.
+static const int kNoPreviousBytecode = kMethodEnd;
+
+static const char* kBytecodeNames[] = {
+#define BYTECODE_NAME(name, branching, format, size, stack_diff, print) #name,
+    BYTECODES_DO(BYTECODE_NAME)
+#undef BYTECODE_NAME
+};
+
+struct FunctionRecord {
+  uint32 snapshot_hash;
+  uword offset;
+  uint64 count;
+};
+
+static bool FunctionRecordCompare(const FunctionRecord* a,
+                                  const FunctionRecord* b) {
+  if (a->snapshot_hash != b->snapshot_hash) {
+    return a->snapshot_hash < b->snapshot_hash;
+  }
+  return a->offset < b->offset;
+}
+
+bool BytecodeProfiler::is_active_ = false;
+static Mutex* profile_mutex = NULL;
+static BytecodeCounters* thread_counters = NULL;
+static Vector<FunctionRecord>* function_records = NULL;
+static uint64 unattributed_count = 0;
+
+BytecodeCounters::BytecodeCounters()
+    : previous_(kNoPreviousBytecode), next_(NULL) {
+  memset(opcodes_, 0, sizeof(opcodes_));
+  memset(pairs_, 0, sizeof(pairs_));
+}
+
+void BytecodeCounters::AddTo(uint64* opcodes, uint64* pairs) const {
+  for (int i = 0; i < Bytecode::kNumBytecodes; i++) {
+    opcodes[i] += opcodes_[i];
+    for (int j = 0; j < Bytecode::kNumBytecodes; j++) {
+      pairs[i * Bytecode::kNumBytecodes + j] += pairs_[i][j];
+    }
+  }
+}
+
+void FunctionCounters::LookupFunction(uint8* bcp) {
+  Function* function = Function::FromBytecodePointer(bcp);
+  auto it = indices_.Find(function);
+  if (it == indices_.End()) {
+    current_ = entries_.size();
+    entries_.PushBack({function, 0});
+    indices_[function] = current_;
+  } else {
+    current_ = it->second;
+  }
+  start_ = function->bytecode_address_for(0);
+  end_ = start_ + function->bytecode_size();
+}
+
+void FunctionCounters::VisitProgramPointers(PointerVisitor* visitor) {
+  for (size_t i = 0; i < entries_.size(); i++) {
+    visitor->Visit(reinterpret_cast<Object**>(&entries_[i].function));
+  }
+}
+
+void FunctionCounters::UpdateFunctions() {
+  HashMap<Function*, int> indices;
+  for (size_t i = 0; i < entries_.size(); i++) {
+    indices[entries_[i].function] = i;
+  }
+  indices_.Swap(indices);
+  // Force a lookup on the next recorded bytecode.
+  start_ = end_ = NULL;
+}
+
+void BytecodeProfiler::Setup() {
+  if (!Flags::profile_bytecodes) return;
+#ifdef DARTINO_ENABLE_DEBUGGING
+  profile_mutex = Platform::CreateMutex();
+  function_records = new Vector<FunctionRecord>();
+  is_active_ = true;
+#else
+  Print::Error("Bytecode profiling requires debugging support.\n");
+#endif
+}
+
+static void AddThreadCounters(uint64* opcodes, uint64* pairs) {
+  for (BytecodeCounters* counters = thread_counters;
+       counters != NULL;
+       counters = counters->next()) {
+    counters->AddTo(opcodes, pairs);
+  }
+}
+
+static void WriteProfile(FILE* file) {
+  int n = Bytecode::kNumBytecodes;
+  uint64* opcodes = new uint64[n];
+  uint64* pairs = new uint64[n * n];
+  memset(opcodes, 0, n * sizeof(uint64));
+  memset(pairs, 0, n * n * sizeof(uint64));
+  AddThreadCounters(opcodes, pairs);
+
+  fprintf(file, "# Bytecode profile from the Dartino VM.\n");
+  for (int i = 0; i < n; i++) {
+    if (opcodes[i] == 0) continue;
+    fprintf(file, "opcode,%s,%" PRIu64 "\n", kBytecodeNames[i], opcodes[i]);
+  }
+  for (int i = 0; i < n; i++) {
+    if (i == kNoPreviousBytecode) continue;
+    for (int j = 0; j < n; j++) {
+      uint64 count = pairs[i * n + j];
+      if (count == 0) continue;
+      fprintf(file, "pair,%s,%s,%" PRIu64 "\n",
+              kBytecodeNames[i], kBytecodeNames[j], count);
+    }
+  }
+  delete[] opcodes;
+  delete[] pairs;
+
+  // Merge the records of processes that ran the same function.
+  Vector<FunctionRecord>* records = function_records;
+  records->Sort(FunctionRecordCompare);
+  size_t i = 0;
+  while (i < records->size()) {
+    FunctionRecord record = (*records)[i++];
+    while (i < records->size() &&
+           (*records)[i].snapshot_hash == record.snapshot_hash &&
+           (*records)[i].offset == record.offset) {
+      record.count += (*records)[i++].count;
+    }
+    fprintf(file, "function,0x%x,0x%lx,%" PRIu64 "\n",
+            record.snapshot_hash, static_cast<unsigned long>(record.offset),
+            record.count);
+  }
+  fprintf(file, "unattributed=%" PRIu64 "\n", unattributed_count);
+}
+
+void BytecodeProfiler::TearDown() {
+  if (!is_active_) return;
+  is_active_ = false;
+
+  FILE* file = fopen(Flags::bytecode_profile_file, "w");
+  if (file == NULL) {
+    FATAL("Bytecode profile file could not be opened for writing");
+  }
+  WriteProfile(file);
+  fclose(file);
+
+  while (thread_counters != NULL) {
+    BytecodeCounters* next = thread_counters->next();
+    delete thread_counters;
+    thread_counters = next;
+  }
+  delete function_records;
+  function_records = NULL;
+  delete profile_mutex;
+  profile_mutex = NULL;
+}
+
+BytecodeCounters* BytecodeProfiler::NewThreadCounters() {
+  if (!is_active_) return NULL;
+  BytecodeCounters* counters = new BytecodeCounters();
+  ScopedLock lock(profile_mutex);
+  counters->next_ = thread_counters;
+  thread_counters = counters;
+  return counters;
+}
+
+void BytecodeProfiler::Record(Process* process, uint8* bcp) {
+  BytecodeCounters* counters = process->bytecode_counters();
+  if (counters == NULL) return;
+  counters->Record(static_cast<Opcode>(*bcp));
+  FunctionCounters* functions = process->function_counters();
+  if (functions == NULL) {
+    functions = new FunctionCounters();
+    process->set_function_counters(functions);
+  }
+  functions->Record(bcp);
+}
+
+void BytecodeProfiler::RecordProcess(Program* program, Process* process) {
+  FunctionCounters* functions = process->function_counters();
+  if (!is_active_ || functions == NULL) return;
+  ScopedLock lock(profile_mutex);
+  for (int i = 0; i < functions->length(); i++) {
+    // Functions can only be identified across runs in optimized programs.
+    if (program->is_optimized()) {
+      FunctionRecord record;
+      record.snapshot_hash = program->snapshot_hash();
+      record.offset = program->OffsetOf(functions->function_at(i));
+      record.count = functions->count_at(i);
+      function_records->PushBack(record);
+    } else {
+      unattributed_count += functions->count_at(i);
+    }
+  }
+}
+
+void BytecodeProfiler::WriteOpcodeCounts(WriteBuffer* buffer) {
+  int n = Bytecode::kNumBytecodes;
+  uint64* opcodes = new uint64[n];
+  uint64* pairs = new uint64[n * n];
+  memset(opcodes, 0, n * sizeof(uint64));
+  memset(pairs, 0, n * n * sizeof(uint64));
+  int pair_count = 0;
+  if (is_active_) {
+    ScopedLock lock(profile_mutex);
+    AddThreadCounters(opcodes, pairs);
+    for (int i = 0; i < n * n; i++) {
+      if (pairs[i] != 0 && i / n != kNoPreviousBytecode) pair_count++;
+    }
+  }
+
+  buffer->WriteInt(n);
+  for (int i = 0; i < n; i++) buffer->WriteInt64(opcodes[i]);
+  buffer->WriteInt(pair_count);
+  for (int i = 0; i < n * n; i++) {
+    if (pairs[i] == 0 || i / n == kNoPreviousBytecode) continue;
+    buffer->WriteInt(i / n);
+    buffer->WriteInt(i % n);
+    buffer->WriteInt64(pairs[i]);
+  }
+  delete[] opcodes;
+  delete[] pairs;
+}
+
+}  // namespace dartino
@@ -0,0 +1,119 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_BYTECODE_PROFILER_H_
+#define SRC_VM_BYTECODE_PROFILER_H_
+
+#include "src/shared/bytecodes.h"
+#include "src/shared/globals.h"
+
+#include "src/vm/hash_map.h"
+#include "src/vm/vector.h"
+
+namespace dartino {
+
+class Function;
+class PointerVisitor;
+class Process;
+class Program;
+class WriteBuffer;
+
+// Per-thread counters for executed bytecodes and pairs of consecutively
+// executed bytecodes. Only the owning worker thread updates them, so no
+// synchronization is needed on the hot path.
+class BytecodeCounters {
+ public:
+  BytecodeCounters();
+
+  void Record(Opcode opcode) {
+    opcodes_[opcode]++;
+    pairs_[previous_][opcode]++;
+    previous_ = opcode;
+  }
+
+  // Add the counts of this thread into [opcodes] and [pairs].
+  void AddTo(uint64* opcodes, uint64* pairs) const;
+
+  BytecodeCounters* next() const { return next_; }
+
+ private:
+  friend class BytecodeProfiler;
+
+  uint64 opcodes_[Bytecode::kNumBytecodes];
+  uint64 pairs_[Bytecode::kNumBytecodes][Bytecode::kNumBytecodes];
+  int previous_;
+  BytecodeCounters* next_;
+};
+
+// Per-process invocation counts of bytecodes executed in each function.
+// The functions are strong program pointers and are updated on program GC.
+class FunctionCounters {
+ public:
+  FunctionCounters() : current_(-1), start_(NULL), end_(NULL) {}
+
+  void Record(uint8* bcp) {
+    if (bcp < start_ || bcp >= end_) LookupFunction(bcp);
+    entries_[current_].count++;
+  }
+
+  int length() const { return entries_.size(); }
+  Function* function_at(int index) const { return entries_[index].function; }
+  uint64 count_at(int index) const { return entries_[index].count; }
+
+  // Program GC support.
+  void VisitProgramPointers(PointerVisitor* visitor);
+  void UpdateFunctions();
+
+ private:
+  struct Entry {
+    Function* function;
+    uint64 count;
+  };
+
+  void LookupFunction(uint8* bcp);
+
+  Vector<Entry> entries_;
+  HashMap<Function*, int> indices_;
+
+  // Cached bytecode range of the function at index [current_].
+  int current_;
+  uint8* start_;
+  uint8* end_;
+};
+
+// The bytecode profiler counts every executed bytecode by routing the
+// interpreter through the debug dispatch prologue. The counts are written
+// to [Flags::bytecode_profile_file] at teardown and can be requested by a
+// debugger session at any time.
+class BytecodeProfiler {
+ public:
+  // Initializes the profiler, called once.
+  static void Setup();
+  // Writes the profile and reverses the Setup call.
+  static void TearDown();
+
+  // Tells whether the profiler is active.
+  static bool is_active() { return is_active_; }
+
+  // Allocate counters for a new worker thread. Returns NULL if the
+  // profiler is not active.
+  static BytecodeCounters* NewThreadCounters();
+
+  // Count the bytecode at [bcp] for [process].
+  static void Record(Process* process, uint8* bcp);
+
+  // Fold the function counts of a process that is about to be deleted into
+  // the global profile.
+  static void RecordProcess(Program* program, Process* process);
+
+  // Write the opcode and pair counts of all threads to [buffer].
+  static void WriteOpcodeCounts(WriteBuffer* buffer);
+
+ private:
+  static bool is_active_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_BYTECODE_PROFILER_H_
@@ -0,0 +1,56 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_CATCH_BLOCK_CACHE_H_
+#define SRC_VM_CATCH_BLOCK_CACHE_H_
+
+#include <string.h>
+
+#include "src/shared/globals.h"
+#include "src/shared/utils.h"
+
+namespace dartino {
+
+// Caches the result of looking up the catch block covering a bytecode
+// pointer. Finding it requires scanning the function to its end to get to
+// the catch table, which makes unwinding deep stacks expensive. Entries
+// without a catch block are cached too, so frames that do not handle the
+// exception are skipped quickly.
+//
+// Entries are keyed by bytecode pointers, so the cache must be cleared
+// whenever program GC moves functions.
+class CatchBlockCache {
+ public:
+  static const int kSize = 64;
+
+  struct Entry {
+    uint8* bcp;
+    // The bytecode pointer to continue at or NULL if [bcp] is not covered
+    // by a catch block.
+    uint8* catch_bcp;
+    // Number of locals in the frame when entering the catch block.
+    int frame_size;
+  };
+
+  CatchBlockCache() { Clear(); }
+
+  // Returns the entry for [bcp]. The entry belongs to a different bytecode
+  // pointer if [bcp] is not in the cache.
+  Entry* Lookup(uint8* bcp) { return &entries_[ComputeIndex(bcp)]; }
+
+  void Clear() { memset(entries_, 0, sizeof(entries_)); }
+
+ private:
+  static uword ComputeIndex(uint8* bcp) {
+    ASSERT(Utils::IsPowerOfTwo(kSize));
+    uword hash = reinterpret_cast<uword>(bcp);
+    return (hash ^ (hash >> 6)) & (kSize - 1);
+  }
+
+  Entry entries_[kSize];
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_CATCH_BLOCK_CACHE_H_
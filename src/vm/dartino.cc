@@ -6,11 +6,15 @@
 
 #include "src/shared/platform.h"
 
+#include "src/vm/blocking_call_pool.h"
+#include "src/vm/bytecode_profiler.h"
 #include "src/vm/event_handler.h"
 #include "src/vm/ffi.h"
 #include "src/vm/object_memory.h"
 #include "src/vm/object.h"
 #include "src/vm/preempter.h"
+#include "src/vm/program_channel.h"
+#include "src/vm/resolver.h"
 #include "src/vm/scheduler.h"
 #include "src/vm/thread.h"
 
@@ -29,6 +33,10 @@ void Dartino::Setup() {
   StaticClassStructures::Setup();
   ForeignFunctionInterface::Setup();
   EventHandler::Setup();
+  BlockingCallPool::Setup();
+  Resolver::Setup();
+  ProgramChannel::Setup();
+  BytecodeProfiler::Setup();
   Scheduler::Setup();
   Preempter::Setup();
 }
@@ -37,6 +45,10 @@ void Dartino::TearDown() {
   Preempter::TearDown();
   Thread::TearDown();
   Scheduler::TearDown();
+  BytecodeProfiler::TearDown();
+  ProgramChannel::TearDown();
+  BlockingCallPool::TearDown();
+  Resolver::TearDown();
   EventHandler::TearDown();
   ForeignFunctionInterface::TearDown();
   StaticClassStructures::TearDown();
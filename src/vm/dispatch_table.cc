@@ -6,6 +6,7 @@
 
 #include "src/vm/dispatch_table.h"
 
+#include "src/vm/bytecode_profiler.h"
 #include "src/vm/native_interpreter.h"
 #include "src/vm/debug_info.h"
 
@@ -14,8 +15,9 @@ namespace dartino {
 void DispatchTable::ResetBreakpoints(
     const ProgramDebugInfo* program_info,
     const ProcessDebugInfo* process_info) {
-  // If stepping, we don't need to clear any previous state.
-  if (process_info != NULL && process_info->is_stepping()) {
+  // If stepping or profiling, we don't need to clear any previous state.
+  if (BytecodeProfiler::is_active() ||
+      (process_info != NULL && process_info->is_stepping())) {
     SetStepping();
     return;
   }
@@ -4,16 +4,22 @@
 
 #include "src/vm/event_handler.h"
 
+#include "src/shared/flags.h"
 #include "src/shared/utils.h"
 #include "src/vm/object.h"
 #include "src/vm/port.h"
 #include "src/vm/process.h"
+#include "src/vm/process_handle.h"
 #include "src/vm/scheduler.h"
 #include "src/vm/thread.h"
 
 namespace dartino {
 
-EventHandler* EventHandler::event_handler_ = NULL;
+EventHandler** EventHandler::shards_ = NULL;
+int EventHandler::shard_count_ = 0;
+HashMap<word, EventRegistration*>* EventHandler::handles_ = NULL;
+Mutex* EventHandler::handles_mutex_ = NULL;
+word EventHandler::next_handle_ = 1;
 
 class PortEventListener : public EventListener {
  public:
@@ -27,19 +33,78 @@ class PortEventListener : public EventListener {
     EventHandler::Send(port_, value, false);
   }
 
+  void Deliver(int64 value, WakeupBatch* batch) {
+    batch->Send(port_, value);
+  }
+
  private:
   Port* port_;
 };
 
 void EventHandler::Setup() {
-  ASSERT(event_handler_ == NULL);
-  event_handler_ = new EventHandler();
+  ASSERT(shards_ == NULL);
+  shard_count_ = Utils::Maximum(1, Flags::event_handler_shards);
+  shards_ = new EventHandler*[shard_count_];
+  for (int i = 0; i < shard_count_; i++) shards_[i] = new EventHandler();
+  handles_ = new HashMap<word, EventRegistration*>();
+  handles_mutex_ = Platform::CreateMutex();
 }
 
 void EventHandler::TearDown() {
-  ASSERT(event_handler_ != NULL);
-  delete event_handler_;
-  event_handler_ = NULL;
+  ASSERT(shards_ != NULL);
+  for (int i = 0; i < shard_count_; i++) delete shards_[i];
+  delete[] shards_;
+  shards_ = NULL;
+  shard_count_ = 0;
+  delete handles_;
+  handles_ = NULL;
+  delete handles_mutex_;
+  handles_mutex_ = NULL;
+}
+
+word EventHandler::NewHandle(EventRegistration* registration) {
+  ScopedLock lock(handles_mutex_);
+  word handle = next_handle_++;
+  (*handles_)[handle] = registration;
+  return handle;
+}
+
+EventRegistration* EventHandler::LookupHandle(word handle) {
+  ScopedLock lock(handles_mutex_);
+  auto it = handles_->Find(handle);
+  if (it == handles_->End()) return NULL;
+  return it->second;
+}
+
+EventRegistration* EventHandler::ReleaseHandle(word handle) {
+  ScopedLock lock(handles_mutex_);
+  auto it = handles_->Find(handle);
+  if (it == handles_->End()) return NULL;
+  EventRegistration* registration = it->second;
+  handles_->Erase(it);
+  return registration;
+}
+
+EventHandler* EventHandler::ForId(Object* id) {
+  if (!id->IsSmi()) return shards_[0];
+  return ForFd(Smi::cast(id)->value());
+}
+
+EventHandler* EventHandler::ForFd(intptr_t fd) {
+  if (fd < 0) return shards_[0];
+  return shards_[fd % shard_count_];
+}
+
+EventHandler* EventHandler::ForPort(Port* port) {
+  // Ports are heap allocated, so the low bits carry no information.
+  uword hash = reinterpret_cast<uword>(port) >> 4;
+  return shards_[hash % shard_count_];
+}
+
+void EventHandler::ReceiverForPortsDiedOnAllShards(Port* ports) {
+  for (int i = 0; i < shard_count_; i++) {
+    shards_[i]->ReceiverForPortsDied(ports);
+  }
 }
 
 EventHandler::EventHandler()
@@ -47,7 +112,9 @@ EventHandler::EventHandler()
       data_(NULL),
       id_(-1),
       running_(true),
-      next_timeout_(INT64_MAX) {}
+      next_timeout_(INT64_MAX),
+      retired_(NULL),
+      io_ring_(NULL) {}
 
 EventHandler::~EventHandler() {
   if (data_ != NULL) {
@@ -67,6 +134,7 @@ EventHandler::~EventHandler() {
     // EventHandler needs to deref them as well after the receiver dies.
   }
 
+  DeleteRetiredRegistrations();
   delete monitor_;
 }
 
@@ -89,6 +157,57 @@ Object* EventHandler::AddPortListener(
   }
 }
 
+void EventHandler::DeleteRetiredRegistrations() {
+  EventRegistration* registration;
+  {
+    ScopedMonitorLock locker(monitor_);
+    registration = retired_;
+    retired_ = NULL;
+  }
+  while (registration != NULL) {
+    EventRegistration* next = registration->next();
+    delete registration;
+    registration = next;
+  }
+}
+
+IoOperation::IoOperation(Kind kind, int fd, void* buffer, int64 length,
+                         int64 offset, Port* port)
+    : kind_(kind),
+      fd_(fd),
+      buffer_(buffer),
+      length_(length),
+      offset_(offset),
+      port_(port),
+      connecting_(false) {
+  port_->IncrementRef();
+}
+
+IoOperation::~IoOperation() { port_->DecrementRef(); }
+
+void IoOperation::Perform() { EventHandler::Send(port_, Execute(), false); }
+
+#if !defined(DARTINO_TARGET_OS_LINUX)
+int64 IoOperation::Execute() {
+  UNIMPLEMENTED();
+  return -1;
+}
+
+EventHandler::Status EventHandler::SubmitIo(IoOperation* operation) {
+  delete operation;
+  return Status::ILLEGAL_STATE;
+}
+
+EventHandler::Status EventHandler::AddRegistration(
+    Object* id, EventRegistration* registration) {
+  return Status::ILLEGAL_STATE;
+}
+
+void EventHandler::RemoveRegistration(EventRegistration* registration) {
+  delete registration;
+}
+#endif  // !defined(DARTINO_TARGET_OS_LINUX)
+
 void EventHandler::ReceiverForPortsDied(Port* ports) {
   ScopedMonitorLock locker(monitor_);
 
@@ -96,7 +215,7 @@ void EventHandler::ReceiverForPortsDied(Port* ports) {
   // our refcount on [port] if necessary.
   if (data_ != NULL) {
     for (Port* port = ports; port != NULL; port = port->next()) {
-      if (timeouts_.RemoveByValue(port)) {
+      if (timeouts_.Cancel(port)) {
         port->DecrementRef();
       }
     }
@@ -118,55 +237,57 @@ void EventHandler::EnsureInitialized() {
   }
 }
 
-// `timeout` is the absolute millisecond that the timeout should fire in terms
-// of `Platform::GetMicroseconds / 1000`.
+// `timeout` is the absolute microsecond that the timeout should fire in terms
+// of `Platform::GetMicroseconds`, or -1 to cancel it.
 void EventHandler::ScheduleTimeout(int64 timeout, Port* port) {
   ASSERT(timeout != INT64_MAX);
 
   // Be sure it's running.
   EnsureInitialized();
 
+  int64 now = Platform::GetMicroseconds();
   ScopedMonitorLock scoped_lock(monitor_);
 
   if (timeout == -1) {
-    if (timeouts_.RemoveByValue(port)) {
-      port->DecrementRef();
-    } else {
-      // If timeout is -1 but we can't find a previous one for the port, we have
-      // already acted on it (but hasn't reached Dart yet). Simply ignore it.
-      return;
-    }
-  } else {
-    if (timeouts_.InsertOrChangePriority(timeout, port)) {
-      port->IncrementRef();
-    }
+    // If we can't find a previous timeout for the port, we have already
+    // acted on it (but it hasn't reached Dart yet). Simply ignore it.
+    if (timeouts_.Cancel(port)) port->DecrementRef();
+    // The event handler may wake up for nothing at the old deadline, which
+    // is cheaper than interrupting it now.
+    return;
   }
 
-  next_timeout_ =
-      timeouts_.IsEmpty() ? INT64_MAX : timeouts_.Minimum().priority;
+  if (timeouts_.Schedule(timeout, port, now)) port->IncrementRef();
 
-  Interrupt();
+  // Only interrupt the event handler if it would sleep past the deadline.
+  if (timeout < next_timeout_) {
+    next_timeout_ = timeout;
+    Interrupt();
+  }
 }
 
 void EventHandler::HandleTimeouts() {
-  // Check timeouts.
-  int64 current_time = Platform::GetMicroseconds() / 1000;
+  int64 current_time = Platform::GetMicroseconds();
 
   ScopedMonitorLock scoped_lock(monitor_);
   if (next_timeout_ > current_time) return;
 
-  int64 next_timeout = INT64_MAX;
-  while (!timeouts_.IsEmpty()) {
-    auto minimum = timeouts_.Minimum();
-    if (minimum.priority <= current_time) {
-      Send(minimum.value, 0, true);
-      timeouts_.RemoveMinimum();
-    } else {
-      next_timeout = minimum.priority;
-      break;
-    }
+  Port* port;
+  while (timeouts_.RemoveExpired(current_time, &port)) {
+    Send(port, 0, true);
+  }
+  next_timeout_ = timeouts_.NextDeadline();
+}
+
+int64 EventHandler::MicrosecondsToNextTimeout() {
+  int64 next_timeout;
+  {
+    ScopedMonitorLock locker(monitor_);
+    next_timeout = next_timeout_;
   }
-  next_timeout_ = next_timeout;
+  if (next_timeout == INT64_MAX) return -1;
+  int64 delay = next_timeout - Platform::GetMicroseconds();
+  return delay < 0 ? 0 : delay;
 }
 
 void EventHandler::Send(Port* port, int64 value, bool release_port) {
@@ -180,4 +301,87 @@ void EventHandler::Send(Port* port, int64 value, bool release_port) {
   if (release_port) port->DecrementRef();
 }
 
+// Close and error events stay pending once they have happened.
+static const int64 kStickyEvents =
+    EventHandler::CLOSE_EVENT | EventHandler::ERROR_EVENT;
+
+EventRegistration::EventRegistration(Port* port)
+    : port_(port), ready_(0), wanted_(0), id_(-1), next_(NULL) {
+  port_->IncrementRef();
+}
+
+EventRegistration::~EventRegistration() { port_->DecrementRef(); }
+
+void EventRegistration::Send(int64 value) {
+  WakeupBatch batch;
+  Deliver(value, &batch);
+  batch.ResumeAll();
+}
+
+void EventRegistration::Deliver(int64 value, WakeupBatch* batch) {
+  ready_.fetch_or(value);
+  int64 wanted = wanted_;
+  if ((value & (wanted | kStickyEvents)) == 0 || wanted == 0) return;
+  // Only one of the event handler and the waiting process gets to take the
+  // events after the waiter has announced what it wants.
+  wanted = wanted_.exchange(0);
+  if (wanted == 0) return;
+  // The waiting process may have taken the events just before, in which case
+  // 0 tells it to look again.
+  batch->Send(port_, Take(wanted));
+}
+
+int64 EventRegistration::Take(int64 mask) {
+  return ready_.fetch_and(~mask) & (mask | kStickyEvents);
+}
+
+int64 EventRegistration::Wait(int64 mask) {
+  int64 events = Take(mask);
+  if (events != 0) return events;
+  wanted_ = mask;
+  events = Take(mask);
+  if (events == 0) return 0;
+  if (wanted_.exchange(0) != 0) return events;
+  // The event handler is about to send a message for the events, so leave
+  // them for the next wait.
+  ready_.fetch_or(events);
+  return 0;
+}
+
+void EventRegistration::MarkReady(int64 mask) { ready_.fetch_or(mask); }
+
+void WakeupBatch::Send(Port* port, int64 value) {
+  ScopedSpinlock locker(port->spinlock());
+  Process* port_process = port->process();
+  if (port_process == NULL) return;
+  port_process->mailbox()->EnqueueLargeInteger(port, value);
+  // The handle keeps the identity of the process after the port is
+  // unlocked, even if the process dies in the meantime.
+  ProcessHandle* handle = port_process->process_handle();
+  for (int i = 0; i < count_; i++) {
+    if (handles_[i] == handle) return;
+  }
+  if (count_ == kMaxProcesses) {
+    port_process->program()->scheduler()->ResumeProcess(port_process);
+    return;
+  }
+  handle->IncrementRef();
+  handles_[count_++] = handle;
+}
+
+void WakeupBatch::ResumeAll() {
+  for (int i = 0; i < count_; i++) {
+    ProcessHandle* handle = handles_[i];
+    {
+      ScopedSpinlock locker(handle->lock());
+      Process* process = handle->process();
+      if (process != NULL) {
+        process->program()->scheduler()->ResumeProcess(process);
+      }
+    }
+    ProcessHandle::DecrementRef(handle);
+  }
+  count_ = 0;
+}
+
 }  // namespace dartino
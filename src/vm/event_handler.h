@@ -5,21 +5,147 @@
 #ifndef SRC_VM_EVENT_HANDLER_H_
 #define SRC_VM_EVENT_HANDLER_H_
 
+#include "src/shared/atomic.h"
 #include "src/shared/globals.h"
-#include "src/vm/priority_heap.h"
+#include "src/vm/blocking_call_pool.h"
+#include "src/vm/hash_map.h"
 #include "src/vm/thread.h"
+#include "src/vm/timer_wheel.h"
 
 namespace dartino {
 
+class IoRing;
 class Monitor;
 class Port;
 class Object;
 class Process;
+class ProcessHandle;
+
+// Delivers the messages for a batch of events and resumes each receiving
+// process once, after all messages have been enqueued.
+class WakeupBatch {
+ public:
+  static const int kMaxProcesses = 64;
+
+  WakeupBatch() : count_(0) {}
+  ~WakeupBatch() { ASSERT(count_ == 0); }
+
+  // Enqueue [value] on [port] without resuming the receiver.
+  void Send(Port* port, int64 value);
+
+  // Resume the receivers of all messages sent since the last call.
+  void ResumeAll();
+
+ private:
+  ProcessHandle* handles_[kMaxProcesses];
+  int count_;
+};
 
 class EventListener {
  public:
   virtual ~EventListener() {}
   virtual void Send(int64 value) = 0;
+
+  // Send [value] as part of [batch]. Listeners that do not wake up
+  // processes send it right away.
+  virtual void Deliver(int64 value, WakeupBatch* batch) { Send(value); }
+
+  // Persistent listeners stay registered after an event and are not deleted
+  // by the event handler.
+  virtual bool IsPersistent() const { return false; }
+};
+
+// A persistent, edge-triggered registration of an event source. Events are
+// cached in the registration and only sent to [port] when the owning process
+// waits for them, so waiting for an event that already happened costs no
+// system call and no message.
+class EventRegistration : public EventListener {
+ public:
+  explicit EventRegistration(Port* port);
+  ~EventRegistration();
+
+  void Send(int64 value);
+  void Deliver(int64 value, WakeupBatch* batch);
+  bool IsPersistent() const { return true; }
+
+  virtual bool IsSocketStream() const { return false; }
+
+  // Returns and clears the pending events in [mask], together with pending
+  // close and error events. If there are none, returns 0 and the events are
+  // sent to the port once they arrive.
+  int64 Wait(int64 mask);
+
+  // Marks the events in [mask] as pending again, e.g. because the last read
+  // did not drain the event source.
+  void MarkReady(int64 mask);
+
+  intptr_t id() const { return id_; }
+  void set_id(intptr_t id) { id_ = id; }
+
+  EventRegistration* next() const { return next_; }
+  void set_next(EventRegistration* next) { next_ = next; }
+
+ private:
+  int64 Take(int64 mask);
+
+  Port* const port_;
+  // Events seen since they were last taken.
+  Atomic<int64> ready_;
+  // The events the owning process is waiting for, or 0.
+  Atomic<int64> wanted_;
+  intptr_t id_;
+  EventRegistration* next_;
+};
+
+// An I/O operation performed asynchronously by the event handler. The
+// result, the number of bytes transferred, the accepted file descriptor or
+// a negative errno value, is sent to [port] on completion. The memory at
+// [buffer] must stay valid until then.
+//
+// Without io_uring, operations on non-blocking sockets and pipes wait for
+// the descriptor to become ready on the event handler thread, and all other
+// operations run on the BlockingCallPool.
+class IoOperation : public BlockingTask {
+ public:
+  enum Kind {
+    READ,
+    WRITE,
+    FSYNC,
+    ACCEPT,
+    CONNECT,
+    NUMBER_OF_KINDS,
+  };
+
+  // Reads and writes at a negative [offset] use the file position. For
+  // CONNECT, [buffer] and [length] are the socket address and its size.
+  IoOperation(Kind kind, int fd, void* buffer, int64 length, int64 offset,
+              Port* port);
+  ~IoOperation();
+
+  // Performs the operation with system calls, which block unless the
+  // descriptor is non-blocking. A non-blocking CONNECT returns -EAGAIN
+  // while the connection is being established.
+  int64 Execute();
+
+  // Executes the operation and sends its result to [port].
+  void Perform();
+
+  Kind kind() const { return kind_; }
+  int fd() const { return fd_; }
+  void* buffer() const { return buffer_; }
+  int64 length() const { return length_; }
+  int64 offset() const { return offset_; }
+  Port* port() const { return port_; }
+
+ private:
+  const Kind kind_;
+  const int fd_;
+  void* const buffer_;
+  const int64 length_;
+  const int64 offset_;
+  Port* const port_;
+  // Whether a non-blocking CONNECT has been started.
+  bool connecting_;
 };
 
 class EventHandler {
@@ -39,9 +165,25 @@ class EventHandler {
     INDEX_OUT_OF_BOUNDS,
   };
 
+  // Creates [Flags::event_handler_shards] event handlers. Each shard has its
+  // own thread, which is started on first use.
   static void Setup();
   static void TearDown();
-  static EventHandler* GlobalInstance() { return event_handler_; }
+
+  static int shard_count() { return shard_count_; }
+  static EventHandler* ShardAt(int index) { return shards_[index]; }
+  static EventHandler* GlobalInstance() { return shards_[0]; }
+
+  // Returns the shard handling the event source [id]. File descriptors are
+  // spread over the shards, other ids all go to the first shard.
+  static EventHandler* ForId(Object* id);
+  static EventHandler* ForFd(intptr_t fd);
+  // Returns the shard handling timeouts for [port], so a timeout is always
+  // rescheduled and cancelled on the shard it was scheduled on.
+  static EventHandler* ForPort(Port* port);
+
+  // Removes the timeouts of [port_list] from all shards.
+  static void ReceiverForPortsDiedOnAllShards(Port* port_list);
 
   EventHandler();
   ~EventHandler();
@@ -50,8 +192,35 @@ class EventHandler {
 
   Status AddEventListener(Object* id, EventListener* event_listener, int flags);
 
+  // Registers the event source [id] for all events until RemoveRegistration
+  // is called. Returns ILLEGAL_STATE if the platform does not support
+  // persistent registrations.
+  Status AddRegistration(Object* id, EventRegistration* registration);
+  // Unregisters and deletes [registration]. It is deleted on the event
+  // handler thread, once no pending events can refer to it.
+  void RemoveRegistration(EventRegistration* registration);
+
+  // Registrations are handed to Dart code as handles that are looked up in a
+  // VM-side table, so a stale or forged handle never reaches freed or
+  // arbitrary memory. Handles are not reused.
+  static word NewHandle(EventRegistration* registration);
+  // Returns the registration for [handle], or NULL if it is not live.
+  static EventRegistration* LookupHandle(word handle);
+  // Removes [handle] from the table and returns its registration, or NULL if
+  // it is not live.
+  static EventRegistration* ReleaseHandle(word handle);
+
+  // Starts [operation] and takes ownership of it. On Linux the operation
+  // is submitted to an io_uring instance if the kernel supports it, see
+  // IoOperation for the fallback. Returns INDEX_OUT_OF_BOUNDS if the
+  // length does not fit in 32 bits or the descriptor cannot be waited for,
+  // and ILLEGAL_STATE if the platform does not support asynchronous I/O.
+  Status SubmitIo(IoOperation* operation);
+
   void ReceiverForPortsDied(Port* port_list);
 
+  // Sends 0 to [port] once the time in microseconds since the epoch is
+  // [timeout]. A [timeout] of -1 cancels the timeout of [port].
   void ScheduleTimeout(int64 timeout, Port* port);
 
   Monitor* monitor() const { return monitor_; }
@@ -59,8 +228,14 @@ class EventHandler {
   static void Send(Port* port, int64 value, bool release_port);
 
  private:
-  // Global EventHandler instance.
-  static EventHandler* event_handler_;
+  // Global EventHandler instances.
+  static EventHandler** shards_;
+  static int shard_count_;
+
+  // The live registrations by handle. Guarded by [handles_mutex_].
+  static HashMap<word, EventRegistration*>* handles_;
+  static Mutex* handles_mutex_;
+  static word next_handle_;
 
   Monitor* monitor_;
   void* data_;
@@ -68,9 +243,18 @@ class EventHandler {
   bool running_;
   ThreadIdentifier thread_;
 
-  PriorityHeapWithValueIndex<int64, Port*> timeouts_;
+  TimerWheel<Port*> timeouts_;
+  // No timeout expires before this time in microseconds. Guarded by
+  // [monitor_].
   int64 next_timeout_;
 
+  // Removed registrations waiting to be deleted. Guarded by [monitor_].
+  EventRegistration* retired_;
+
+  // The io_uring instance, or NULL if I/O operations are not submitted to
+  // the kernel.
+  IoRing* io_ring_;
+
   static void* RunEventHandler(void* peer);
   void EnsureInitialized();
 
@@ -78,6 +262,9 @@ class EventHandler {
   void Run();
   void Interrupt();
   void HandleTimeouts();
+  // Returns the microseconds until the next timeout, or -1 if there is none.
+  int64 MicrosecondsToNextTimeout();
+  void DeleteRetiredRegistrations();
 };
 
 }  // namespace dartino
@@ -67,18 +67,9 @@ void EventHandler::Run() {
   osMessageQId queue = DeviceManager::GetDeviceManager()->GetMailQueue();
 
   while (true) {
-    int64 next_timeout;
-    {
-      ScopedMonitorLock locker(monitor_);
-      next_timeout = next_timeout_;
-    }
-
-    if (next_timeout == INT64_MAX) {
-      next_timeout = -1;
-    } else {
-      next_timeout -= Platform::GetMicroseconds() / 1000;
-      if (next_timeout < 0) next_timeout = 0;
-    }
+    // Round up to whole milliseconds to not wake up early.
+    int64 next_timeout = MicrosecondsToNextTimeout();
+    if (next_timeout > 0) next_timeout = (next_timeout + 999) / 1000;
 
     osEvent event = osMessageGet(queue, static_cast<int>(next_timeout));
     HandleTimeouts();
@@ -7,14 +7,24 @@
 #include "src/vm/event_handler.h"
 
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
 #include <sys/types.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <string.h>
 #include <unistd.h>
 
+#include "src/shared/flags.h"
 #include "src/shared/utils.h"
 #include "src/vm/thread.h"
 #include "src/vm/object.h"
 #include "src/vm/process.h"
+#include "src/vm/spinlock.h"
 
 // Some versions of android sys/epoll does not define
 // EPOLLRDHUP. However, it works as intended, so we just
@@ -23,10 +33,324 @@
 #define EPOLLRDHUP 0x2000
 #endif  // !defined(EPOLLRDHUP)
 
+// io_uring is used when the kernel headers are recent enough to describe
+// all the operations we submit. Older kernels are detected at runtime.
+#if defined(__NR_io_uring_setup) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(IORING_FEAT_FAST_POLL)
+#define DARTINO_HAS_IO_URING
+#endif
+#endif
+#endif
+
 namespace dartino {
 
+int64 IoOperation::Execute() {
+  ssize_t result = -1;
+  switch (kind_) {
+    case READ:
+      if (offset_ < 0) {
+        result = TEMP_FAILURE_RETRY(read(fd_, buffer_, length_));
+      } else {
+        result = TEMP_FAILURE_RETRY(pread64(fd_, buffer_, length_, offset_));
+      }
+      break;
+    case WRITE:
+      if (offset_ < 0) {
+        result = TEMP_FAILURE_RETRY(write(fd_, buffer_, length_));
+      } else {
+        result = TEMP_FAILURE_RETRY(pwrite64(fd_, buffer_, length_, offset_));
+      }
+      break;
+    case FSYNC:
+      result = TEMP_FAILURE_RETRY(fsync(fd_));
+      break;
+    case ACCEPT:
+      result = TEMP_FAILURE_RETRY(accept(fd_, NULL, NULL));
+      break;
+    case CONNECT:
+      if (connecting_) {
+        // The socket became writable, so the connection attempt is over.
+        int error = 0;
+        socklen_t size = sizeof(error);
+        if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &size) != 0) {
+          return -errno;
+        }
+        return -error;
+      }
+      result = connect(fd_, reinterpret_cast<struct sockaddr*>(buffer_),
+                       static_cast<socklen_t>(length_));
+      if (result == -1 && errno == EINPROGRESS) {
+        connecting_ = true;
+        return -EAGAIN;
+      }
+      break;
+    default:
+      UNREACHABLE();
+  }
+  return result == -1 ? -errno : result;
+}
+
+// Waits for a non-blocking descriptor to become ready for [operation] and
+// executes it on the event handler thread.
+class IoReadinessListener : public EventListener {
+ public:
+  explicit IoReadinessListener(IoOperation* operation)
+      : operation_(operation), port_(operation->port()) {
+    port_->IncrementRef();
+  }
+
+  ~IoReadinessListener() {
+    delete operation_;
+    port_->DecrementRef();
+  }
+
+  // Registers [listener] for the next event it waits for and takes
+  // ownership of it.
+  static EventHandler::Status Start(IoReadinessListener* listener) {
+    IoOperation* operation = listener->operation_;
+    bool read = operation->kind() == IoOperation::READ ||
+                operation->kind() == IoOperation::ACCEPT;
+    return EventHandler::ForFd(operation->fd())->AddEventListener(
+        Smi::FromWord(operation->fd()), listener,
+        read ? EventHandler::READ_EVENT : EventHandler::WRITE_EVENT);
+  }
+
+  void Send(int64 value) {
+    WakeupBatch batch;
+    Deliver(value, &batch);
+    batch.ResumeAll();
+  }
+
+  void Deliver(int64 value, WakeupBatch* batch) {
+    int64 result = operation_->Execute();
+    if (result == -EAGAIN || result == -EWOULDBLOCK) {
+      // This listener is deleted after the event, so the operation waits
+      // for the next one in a new listener.
+      IoReadinessListener* next = new IoReadinessListener(operation_);
+      operation_ = NULL;
+      if (Start(next) == EventHandler::Status::OK) return;
+      result = -EBADF;
+    }
+    batch->Send(port_, result);
+  }
+
+ private:
+  IoOperation* operation_;
+  Port* const port_;
+};
+
+// Tells whether [operation] can wait for its descriptor to become ready,
+// instead of blocking a thread.
+static bool CanWaitForReadiness(IoOperation* operation) {
+  if (operation->kind() == IoOperation::FSYNC) return false;
+  int flags = fcntl(operation->fd(), F_GETFL);
+  if (flags == -1 || (flags & O_NONBLOCK) == 0) return false;
+  // Regular files are always ready and cannot be added to an epoll set.
+  struct stat info;
+  return fstat(operation->fd(), &info) == 0 && !S_ISREG(info.st_mode);
+}
+
+#if defined(DARTINO_HAS_IO_URING)
+
+// A submission and completion queue pair shared with the kernel. Any
+// thread can submit operations, completions are only reaped by the event
+// handler thread, which is woken up through an eventfd in its epoll set.
+class IoRing {
+ public:
+  // Returns NULL if the kernel does not support io_uring or lacks some of
+  // the operations.
+  static IoRing* Create();
+  ~IoRing();
+
+  int event_fd() const { return event_fd_; }
+
+  // Returns false if the submission queue is full.
+  bool Submit(IoOperation* operation);
+
+  // Delivers the results of all completed operations to [batch].
+  void Complete(WakeupBatch* batch);
+
+ private:
+  static const unsigned kEntries = 256;
+
+  IoRing() : ring_fd_(-1), event_fd_(-1), sq_ring_(MAP_FAILED),
+             cq_ring_(MAP_FAILED), sqes_(MAP_FAILED) {}
+
+  bool Map(const struct io_uring_params& params);
+  void FillEntry(struct io_uring_sqe* entry, IoOperation* operation);
+
+  int ring_fd_;
+  int event_fd_;
+
+  void* sq_ring_;
+  size_t sq_ring_size_;
+  void* cq_ring_;
+  size_t cq_ring_size_;
+  void* sqes_;
+  size_t sqes_size_;
+
+  uint32* sq_head_;
+  uint32* sq_tail_;
+  uint32 sq_mask_;
+  uint32 sq_entries_;
+  uint32* sq_array_;
+  uint32* cq_head_;
+  uint32* cq_tail_;
+  uint32 cq_mask_;
+  struct io_uring_cqe* cqes_;
+
+  // Serializes submitters.
+  Spinlock lock_;
+};
+
+IoRing* IoRing::Create() {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  IoRing* ring = new IoRing();
+  ring->ring_fd_ = syscall(__NR_io_uring_setup, kEntries, &params);
+  if (ring->ring_fd_ == -1 ||
+      (params.features & IORING_FEAT_FAST_POLL) == 0 ||
+      !ring->Map(params)) {
+    delete ring;
+    return NULL;
+  }
+  ring->event_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (ring->event_fd_ == -1 ||
+      syscall(__NR_io_uring_register, ring->ring_fd_, IORING_REGISTER_EVENTFD,
+              &ring->event_fd_, 1) != 0) {
+    delete ring;
+    return NULL;
+  }
+  return ring;
+}
+
+bool IoRing::Map(const struct io_uring_params& params) {
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32);
+  cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = Utils::Maximum(sq_ring_size_,
+                                                   cq_ring_size_);
+  }
+  sq_ring_ = mmap(NULL, sq_ring_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) return false;
+  if (!single_mmap) {
+    cq_ring_ = mmap(NULL, cq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) return false;
+  }
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  sqes_ = mmap(NULL, sqes_size_, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes_ == MAP_FAILED) return false;
+
+  uint8* sq = reinterpret_cast<uint8*>(sq_ring_);
+  uint8* cq = reinterpret_cast<uint8*>(single_mmap ? sq_ring_ : cq_ring_);
+  sq_head_ = reinterpret_cast<uint32*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32*>(sq + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<uint32*>(sq + params.sq_off.ring_mask);
+  sq_entries_ = *reinterpret_cast<uint32*>(sq + params.sq_off.ring_entries);
+  sq_array_ = reinterpret_cast<uint32*>(sq + params.sq_off.array);
+  cq_head_ = reinterpret_cast<uint32*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32*>(cq + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<uint32*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+  return true;
+}
+
+IoRing::~IoRing() {
+  if (sqes_ != MAP_FAILED) munmap(sqes_, sqes_size_);
+  if (cq_ring_ != MAP_FAILED) munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_ != MAP_FAILED) munmap(sq_ring_, sq_ring_size_);
+  if (event_fd_ != -1) close(event_fd_);
+  if (ring_fd_ != -1) close(ring_fd_);
+}
+
+void IoRing::FillEntry(struct io_uring_sqe* entry, IoOperation* operation) {
+  memset(entry, 0, sizeof(*entry));
+  entry->fd = operation->fd();
+  entry->user_data = reinterpret_cast<uint64>(operation);
+  switch (operation->kind()) {
+    case IoOperation::READ:
+    case IoOperation::WRITE:
+      entry->opcode = operation->kind() == IoOperation::READ
+          ? IORING_OP_READ : IORING_OP_WRITE;
+      entry->addr = reinterpret_cast<uint64>(operation->buffer());
+      entry->len = static_cast<uint32>(operation->length());
+      // An offset of -1 makes the kernel use and update the file position.
+      entry->off = operation->offset() < 0
+          ? static_cast<uint64>(-1) : operation->offset();
+      break;
+    case IoOperation::FSYNC:
+      entry->opcode = IORING_OP_FSYNC;
+      break;
+    case IoOperation::ACCEPT:
+      entry->opcode = IORING_OP_ACCEPT;
+      break;
+    case IoOperation::CONNECT:
+      entry->opcode = IORING_OP_CONNECT;
+      entry->addr = reinterpret_cast<uint64>(operation->buffer());
+      entry->off = operation->length();
+      break;
+    default:
+      UNREACHABLE();
+  }
+}
+
+bool IoRing::Submit(IoOperation* operation) {
+  ScopedSpinlock locker(&lock_);
+  uint32 tail = *sq_tail_;
+  uint32 head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (tail - head >= sq_entries_) return false;
+  uint32 index = tail & sq_mask_;
+  FillEntry(&reinterpret_cast<struct io_uring_sqe*>(sqes_)[index], operation);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  long submitted = TEMP_FAILURE_RETRY(
+      syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, NULL, 0));
+  if (submitted == 1) return true;
+  // The kernel only consumes entries in io_uring_enter, so an entry it did
+  // not take, e.g. because it is short of memory or completions, can be
+  // withdrawn and the operation performed without the ring.
+  __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+  return false;
+}
+
+void IoRing::Complete(WakeupBatch* batch) {
+  uint64 count;
+  TEMP_FAILURE_RETRY(read(event_fd_, &count, sizeof(count)));
+  uint32 head = *cq_head_;
+  uint32 tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    struct io_uring_cqe* completion = &cqes_[head & cq_mask_];
+    IoOperation* operation =
+        reinterpret_cast<IoOperation*>(completion->user_data);
+    batch->Send(operation->port(), completion->res);
+    delete operation;
+    head++;
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+}
+
+#else  // defined(DARTINO_HAS_IO_URING)
+
+class IoRing {
+ public:
+  static IoRing* Create() { return NULL; }
+  int event_fd() const { return -1; }
+  bool Submit(IoOperation* operation) { return false; }
+  void Complete(WakeupBatch* batch) {}
+};
+
+#endif  // defined(DARTINO_HAS_IO_URING)
+
 void EventHandler::Create() {
-  int* fds = new int[2];
+  // The interrupt pipe and a timer for the timeouts.
+  int* fds = new int[3];
   if (pipe(fds) != 0) FATAL("Failed to start the event handler pipe\n");
   int status = fcntl(fds[0], F_SETFD, FD_CLOEXEC);
   if (status == -1) FATAL("Failed making read pipe close on exec.");
@@ -43,11 +367,57 @@ void EventHandler::Create() {
   event.data.fd = fds[0];
   epoll_ctl(id_, EPOLL_CTL_ADD, fds[0], &event);
 
+  fds[2] = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fds[2] == -1) FATAL("Failed creating the event handler timer.");
+  event.events = EPOLLIN;
+  event.data.fd = fds[2];
+  epoll_ctl(id_, EPOLL_CTL_ADD, fds[2], &event);
+
+  if (Flags::io_uring) io_ring_ = IoRing::Create();
+  if (io_ring_ != NULL) {
+    event.events = EPOLLIN;
+    event.data.ptr = io_ring_;
+    epoll_ctl(id_, EPOLL_CTL_ADD, io_ring_->event_fd(), &event);
+  }
+
   data_ = reinterpret_cast<void*>(fds);
 }
 
+// Maximum number of events harvested by a single epoll_wait call.
+static const int kMaxEvents = 64;
+
+static int64 EventMask(int events) {
+  int64 mask = 0;
+  if ((events & EPOLLIN) != 0) mask |= EventHandler::READ_EVENT;
+  if ((events & EPOLLOUT) != 0) mask |= EventHandler::WRITE_EVENT;
+  if ((events & EPOLLRDHUP) != 0) mask |= EventHandler::CLOSE_EVENT;
+  if ((events & EPOLLHUP) != 0) mask |= EventHandler::CLOSE_EVENT;
+  if ((events & EPOLLERR) != 0) mask |= EventHandler::ERROR_EVENT;
+  return mask;
+}
+
+// Arms [timer_fd] to expire at [deadline] in microseconds since the epoch,
+// the clock used by Platform::GetMicroseconds. INT64_MAX disarms it.
+static void ArmTimer(int timer_fd, int64 deadline) {
+  struct itimerspec spec;
+  memset(&spec, 0, sizeof(spec));
+  if (deadline != INT64_MAX) {
+    spec.it_value.tv_sec = deadline / 1000000;
+    spec.it_value.tv_nsec = (deadline % 1000000) * 1000;
+    // A zero value would disarm the timer.
+    if (deadline <= 0) spec.it_value.tv_nsec = 1;
+  }
+  timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
 void EventHandler::Run() {
   int* fds = reinterpret_cast<int*>(data_);
+  struct epoll_event events[kMaxEvents];
+  WakeupBatch batch;
+  // The timeouts are waited for with a timer, which has a finer resolution
+  // than the epoll_wait timeout. It is only rearmed when the next timeout
+  // changes.
+  int64 armed_timeout = INT64_MAX;
 
   while (true) {
     int64 next_timeout;
@@ -55,51 +425,63 @@ void EventHandler::Run() {
       ScopedMonitorLock locker(monitor_);
       next_timeout = next_timeout_;
     }
-
-    if (next_timeout == INT64_MAX) {
-      next_timeout = -1;
-    } else {
-      next_timeout -= Platform::GetMicroseconds() / 1000;
-      if (next_timeout < 0) next_timeout = 0;
+    if (next_timeout != armed_timeout) {
+      ArmTimer(fds[2], next_timeout);
+      armed_timeout = next_timeout;
     }
 
-    struct epoll_event event;
-    int status = epoll_wait(id_, &event, 1, next_timeout);
+    int count = epoll_wait(id_, events, kMaxEvents, -1);
 
     HandleTimeouts();
 
-    if (status != 1) continue;
+    bool interrupted = false;
+    for (int i = 0; i < count; i++) {
+      if (events[i].data.fd == fds[0]) {
+        interrupted = true;
+        continue;
+      }
+      if (events[i].data.fd == fds[2]) {
+        uint64 expirations;
+        TEMP_FAILURE_RETRY(read(fds[2], &expirations, sizeof(expirations)));
+        // The timer has to be rearmed, even for the same deadline.
+        armed_timeout = -1;
+        continue;
+      }
+      if (io_ring_ != NULL && events[i].data.ptr == io_ring_) {
+        io_ring_->Complete(&batch);
+        continue;
+      }
+      EventListener* event_listener =
+          reinterpret_cast<EventListener*>(events[i].data.ptr);
+      event_listener->Deliver(EventMask(events[i].events), &batch);
+      if (!event_listener->IsPersistent()) delete event_listener;
+    }
+    batch.ResumeAll();
 
-    int events = event.events;
+    if (!interrupted) continue;
 
-    if (event.data.fd == fds[0]) {
-      if (!running_) {
-        ScopedMonitorLock locker(monitor_);
-        close(id_);
-        close(fds[0]);
-        close(fds[1]);
-        delete[] fds;
-        data_ = NULL;
-        monitor_->Notify();
-        return;
-      }
+    // Registrations are retired after they were removed from the epoll
+    // set, and the interrupt that follows shows that no later batch can
+    // refer to them.
+    DeleteRetiredRegistrations();
 
-      char b;
-      TEMP_FAILURE_RETRY(read(fds[0], &b, 1));
-      continue;
+    if (!running_) {
+      ScopedMonitorLock locker(monitor_);
+      close(id_);
+      delete io_ring_;
+      io_ring_ = NULL;
+      close(fds[0]);
+      close(fds[1]);
+      close(fds[2]);
+      delete[] fds;
+      data_ = NULL;
+      monitor_->Notify();
+      return;
     }
 
-    int64 mask = 0;
-    if ((events & EPOLLIN) != 0) mask |= READ_EVENT;
-    if ((events & EPOLLOUT) != 0) mask |= WRITE_EVENT;
-    if ((events & EPOLLRDHUP) != 0) mask |= CLOSE_EVENT;
-    if ((events & EPOLLHUP) != 0) mask |= CLOSE_EVENT;
-    if ((events & EPOLLERR) != 0) mask |= ERROR_EVENT;
-
-    EventListener* event_listener =
-        reinterpret_cast<EventListener*>(event.data.ptr);
-    event_listener->Send(mask);
-    delete event_listener;
+    // Drain the interrupts that piled up since the last wakeup.
+    char buffer[kMaxEvents];
+    TEMP_FAILURE_RETRY(read(fds[0], buffer, sizeof(buffer)));
   }
 }
 
@@ -138,6 +520,56 @@ EventHandler::Status EventHandler::AddEventListener(
   return Status::OK;
 }
 
+EventHandler::Status EventHandler::AddRegistration(
+    Object* id, EventRegistration* registration) {
+  EnsureInitialized();
+
+  int fd;
+  if (id->IsSmi()) {
+    fd = Smi::cast(id)->value();
+  } else if (id->IsLargeInteger()) {
+    fd = LargeInteger::cast(id)->value();
+  } else {
+    return Status::WRONG_ARGUMENT_TYPE;
+  }
+
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLHUP | EPOLLET;
+  event.data.ptr = registration;
+  int result = epoll_ctl(id_, EPOLL_CTL_ADD, fd, &event);
+  if (result == -1 && errno == EEXIST) {
+    // The fd was used with one-shot listeners before.
+    result = epoll_ctl(id_, EPOLL_CTL_MOD, fd, &event);
+  }
+  if (result == -1) return Status::INDEX_OUT_OF_BOUNDS;
+  registration->set_id(fd);
+  return Status::OK;
+}
+
+EventHandler::Status EventHandler::SubmitIo(IoOperation* operation) {
+  // io_uring lengths are 32 bits.
+  if (operation->length() > UINT32_MAX) {
+    delete operation;
+    return Status::INDEX_OUT_OF_BOUNDS;
+  }
+  EnsureInitialized();
+  if (io_ring_ != NULL && io_ring_->Submit(operation)) return Status::OK;
+
+  if (CanWaitForReadiness(operation)) {
+    return IoReadinessListener::Start(new IoReadinessListener(operation));
+  }
+  BlockingCallPool::GlobalInstance()->Submit(operation);
+  return Status::OK;
+}
+
+void EventHandler::RemoveRegistration(EventRegistration* registration) {
+  epoll_ctl(id_, EPOLL_CTL_DEL, registration->id(), NULL);
+  ScopedMonitorLock locker(monitor_);
+  registration->set_next(retired_);
+  retired_ = registration;
+  Interrupt();
+}
+
 }  // namespace dartino
 
 #endif  // defined(DARTINO_TARGET_OS_LINUX)
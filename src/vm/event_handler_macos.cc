@@ -42,20 +42,14 @@ void EventHandler::Run() {
   int* fds = reinterpret_cast<int*>(data_);
 
   while (true) {
-    int64 next_timeout;
-    {
-      ScopedMonitorLock locker(monitor_);
-      next_timeout = next_timeout_;
-    }
+    int64 next_timeout = MicrosecondsToNextTimeout();
 
     timespec ts;
     timespec* interval = NULL;
 
-    if (next_timeout != INT64_MAX) {
-      next_timeout -= Platform::GetMicroseconds() / 1000;
-      if (next_timeout < 0) next_timeout = 0;
-      ts.tv_sec = next_timeout / 1000;
-      ts.tv_nsec = (next_timeout % 1000) * 1000000;
+    if (next_timeout != -1) {
+      ts.tv_sec = next_timeout / 1000000;
+      ts.tv_nsec = (next_timeout % 1000000) * 1000;
       interval = &ts;
     }
 
@@ -79,18 +79,14 @@ void EventHandler::Run() {
   EventHandlerData* data = reinterpret_cast<EventHandlerData*>(data_);
 
   while (true) {
-    int64 next_timeout;
-    {
-      ScopedMonitorLock locker(monitor_);
-      next_timeout = next_timeout_;
-    }
+    int64 next_timeout = MicrosecondsToNextTimeout();
 
     DWORD sleep_duration_ms;
-    if (next_timeout == INT64_MAX) {
+    if (next_timeout == -1) {
       sleep_duration_ms = INFINITE;
     } else {
-      sleep_duration_ms = next_timeout - Platform::GetMicroseconds() / 1000;
-      if (sleep_duration_ms < 0) sleep_duration_ms = 0;
+      // Round up to whole milliseconds to not wake up early.
+      sleep_duration_ms = static_cast<DWORD>((next_timeout + 999) / 1000);
     }
 
     int status = WaitForSingleObject(data->control_event, sleep_duration_ms);
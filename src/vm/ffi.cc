@@ -5,6 +5,7 @@
 #include "src/vm/ffi.h"
 
 #include "src/shared/asan_helper.h"
+#include "src/vm/blocking_call_pool.h"
 #include "src/vm/natives.h"
 #include "src/vm/object.h"
 #include "src/vm/port.h"
@@ -1036,6 +1037,32 @@ BEGIN_NATIVE(ForeignLCallwLw) {
 }
 END_NATIVE()
 
+BEGIN_LEAF_NATIVE(ForeignBlockingCall) {
+  word address = AsForeignWord(arguments[0]);
+  if (!arguments[1]->IsSmi() || !arguments[2]->IsSmi() ||
+      !arguments[10]->IsPort()) {
+    return Failure::wrong_argument_type();
+  }
+  word kind = Smi::cast(arguments[1])->value();
+  word argc = Smi::cast(arguments[2])->value();
+  if (kind < 0 || kind >= BlockingCall::NUMBER_OF_KINDS || argc < 0 ||
+      argc > BlockingCall::kMaxArguments) {
+    return Failure::index_out_of_bounds();
+  }
+  word args[BlockingCall::kMaxArguments];
+  for (int i = 0; i < BlockingCall::kMaxArguments; i++) {
+    args[i] = AsForeignWord(arguments[3 + i]);
+  }
+  Port* port = Port::FromDartObject(arguments[10]);
+  if (port == NULL) return Failure::illegal_state();
+  BlockingCall* call =
+      new BlockingCall(static_cast<BlockingCall::Kind>(kind), address,
+                       static_cast<int>(argc), args, port);
+  BlockingCallPool::GlobalInstance()->Submit(call);
+  return process->program()->null_object();
+}
+END_NATIVE()
+
 #define DEFINE_FOREIGN_ACCESSORS_INTEGER(suffix, type)                    \
                                                                           \
   BEGIN_LEAF_NATIVE(ForeignGet##suffix) {                                      \
@@ -38,6 +38,21 @@ UNIMPLEMENTED_NATIVE(ForeignLibraryGetFunction)
 UNIMPLEMENTED_NATIVE(ForeignLibraryBundlePath)
 
 UNIMPLEMENTED_NATIVE(ForeignErrno)
+UNIMPLEMENTED_NATIVE(ForeignSetErrno)
+
+UNIMPLEMENTED_NATIVE(ForeignMapFile)
+
+BEGIN_NATIVE(ForeignMarkMapped) {
+  UNIMPLEMENTED();
+  return NULL;
+}
+END_NATIVE()
+
+BEGIN_NATIVE(ForeignUnmap) {
+  UNIMPLEMENTED();
+  return NULL;
+}
+END_NATIVE()
 
 }  // namespace dartino
 
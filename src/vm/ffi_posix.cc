@@ -11,7 +11,9 @@
 #include <dlfcn.h>
 #include <errno.h>
 #include <libgen.h>
+#include <sys/mman.h>
 #include <sys/param.h>
+#include <sys/stat.h>
 
 #include "src/shared/platform.h"
 #include "src/shared/utils.h"
@@ -159,6 +161,76 @@ END_NATIVE()
 BEGIN_LEAF_NATIVE(ForeignErrno) { return Smi::FromWord(errno); }
 END_NATIVE()
 
+BEGIN_LEAF_NATIVE(ForeignSetErrno) {
+  errno = AsForeignWord(arguments[0]);
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+static void FinalizeMappedMemory(HeapObject* foreign, void* arg) {
+  Instance* instance = Instance::cast(foreign);
+  uword address = instance->GetConsecutiveSmis(0);
+  uword length = Smi::cast(instance->GetInstanceField(2))->value();
+  // The address is cleared when the memory is unmapped explicitly.
+  if (address == 0) return;
+  munmap(reinterpret_cast<void*>(address), length);
+  reinterpret_cast<TwoSpaceHeap*>(arg)->FreedMappedMemory(length);
+}
+
+BEGIN_LEAF_NATIVE(ForeignMapFile) {
+  if (!arguments[0]->IsSmi() || !arguments[2]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  word fd = Smi::cast(arguments[0])->value();
+  int64 offset = AsForeignInt64(arguments[1]);
+  word length = Smi::cast(arguments[2])->value();
+  if (fd < 0 || offset < 0 || length <= 0) {
+    return Failure::index_out_of_bounds();
+  }
+  // Pages of a regular file that lie past its end raise SIGBUS when they are
+  // touched, so the range has to be inside the file.
+  struct stat st;
+  if (fstat(fd, &st) != 0) return Smi::FromWord(-errno);
+  if (S_ISREG(st.st_mode) && offset + length > st.st_size) {
+    return Failure::index_out_of_bounds();
+  }
+  Object* cached_integer = process->EnsureLargeIntegerIsAvailable();
+  if (cached_integer->IsRetryAfterGCFailure()) return cached_integer;
+
+  int protection = PROT_READ;
+  if (arguments[3]->IsTrue()) protection |= PROT_WRITE;
+  void* address = mmap(NULL, length, protection, MAP_SHARED, fd, offset);
+  // Errors are negative, which no mapping address is.
+  if (address == MAP_FAILED) return Smi::FromWord(-errno);
+  uint64 value = reinterpret_cast<uint64>(address);
+  if (Smi::IsValid(value)) return Smi::FromWord(value);
+  LargeInteger* result = process->ConsumeLargeInteger();
+  result->set_value(value);
+  return result;
+}
+END_NATIVE()
+
+BEGIN_NATIVE(ForeignMarkMapped) {
+  HeapObject* foreign = HeapObject::cast(arguments[0]);
+  word length = AsForeignWord(arguments[1]);
+  process->heap()->AllocatedMappedMemory(length);
+  process->RegisterFinalizer(foreign, FinalizeMappedMemory, process->heap());
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_NATIVE(ForeignUnmap) {
+  Instance* instance = Instance::cast(arguments[0]);
+  uword address = instance->GetConsecutiveSmis(0);
+  uword length = Smi::cast(instance->GetInstanceField(2))->value();
+  if (munmap(reinterpret_cast<void*>(address), length) != 0) {
+    return Failure::illegal_state();
+  }
+  process->heap()->FreedMappedMemory(length);
+  return process->program()->null_object();
+}
+END_NATIVE()
+
 }  // namespace dartino
 
 #endif  // DARTINO_ENABLE_FFI
@@ -87,6 +87,30 @@ BEGIN_LEAF_NATIVE(ForeignErrno) {
 }
 END_NATIVE()
 
+BEGIN_LEAF_NATIVE(ForeignSetErrno) {
+  UNIMPLEMENTED();
+  return Smi::FromWord(0);
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(ForeignMapFile) {
+  UNIMPLEMENTED();
+  return Smi::FromWord(0);
+}
+END_NATIVE()
+
+BEGIN_NATIVE(ForeignMarkMapped) {
+  UNIMPLEMENTED();
+  return Smi::FromWord(0);
+}
+END_NATIVE()
+
+BEGIN_NATIVE(ForeignUnmap) {
+  UNIMPLEMENTED();
+  return Smi::FromWord(0);
+}
+END_NATIVE()
+
 }  // namespace dartino
 
 #endif  // DARTINO_ENABLE_FFI
@@ -164,6 +164,28 @@ END_NATIVE()
 BEGIN_LEAF_NATIVE(ForeignErrno) { return Smi::FromWord(GetLastError()); }
 END_NATIVE()
 
+BEGIN_LEAF_NATIVE(ForeignSetErrno) {
+  SetLastError(AsForeignWord(arguments[0]));
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+// Mapping files is not supported on Windows yet.
+BEGIN_LEAF_NATIVE(ForeignMapFile) { return Failure::illegal_state(); }
+END_NATIVE()
+
+BEGIN_NATIVE(ForeignMarkMapped) {
+  UNIMPLEMENTED();
+  return Smi::FromWord(0);
+}
+END_NATIVE()
+
+BEGIN_NATIVE(ForeignUnmap) {
+  UNIMPLEMENTED();
+  return Smi::FromWord(0);
+}
+END_NATIVE()
+
 }  // namespace dartino
 
 #endif  // DARTINO_ENABLE_FFI
@@ -0,0 +1,148 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/file_transfer.h"
+
+#if defined(DARTINO_TARGET_OS_POSIX)
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+#if defined(DARTINO_TARGET_OS_LINUX)
+#include <sys/sendfile.h>
+#endif
+
+#include <stdlib.h>
+
+#include "src/shared/utils.h"
+#include "src/vm/object.h"
+#include "src/vm/port.h"
+
+namespace dartino {
+
+FileTransfer::FileTransfer(int socket, int file, int64 offset, int64 length,
+                           Port* port)
+    : socket_(socket),
+      file_(file),
+      offset_(offset),
+      remaining_(length),
+      transferred_(0),
+      use_sendfile_(true),
+      port_(port) {
+  port_->IncrementRef();
+}
+
+FileTransfer::~FileTransfer() { port_->DecrementRef(); }
+
+FileTransfer* FileTransfer::Rest() {
+  FileTransfer* rest =
+      new FileTransfer(socket_, file_, offset_, remaining_, port_);
+  rest->transferred_ = transferred_;
+  rest->use_sendfile_ = use_sendfile_;
+  return rest;
+}
+
+void FileTransfer::Send(int64 value) {
+  BlockingCallPool::GlobalInstance()->Submit(Rest());
+}
+
+void FileTransfer::Perform() {
+  int64 result;
+  if (!Transfer(&result)) {
+    if (Start(Rest()) == EventHandler::Status::OK) return;
+    result = -EBADF;
+  }
+  EventHandler::Send(port_, result, false);
+}
+
+#if defined(DARTINO_TARGET_OS_POSIX)
+
+EventHandler::Status FileTransfer::Start(FileTransfer* transfer) {
+  Smi* id = Smi::FromWord(transfer->socket_);
+  return EventHandler::ForFd(transfer->socket_)
+      ->AddEventListener(id, transfer, EventHandler::WRITE_EVENT);
+}
+
+bool FileTransfer::Transfer(int64* result) {
+  while (remaining_ > 0) {
+    int64 count;
+#if defined(DARTINO_TARGET_OS_LINUX)
+    if (use_sendfile_) {
+      off_t offset = offset_;
+      size_t length = Utils::Minimum<int64>(remaining_, 1 * GB);
+      count = sendfile(socket_, file_, &offset, length);
+      if (count == -1 && (errno == EINVAL || errno == ENOSYS)) {
+        // The file cannot be mapped, so copy it instead.
+        use_sendfile_ = false;
+        continue;
+      }
+    } else {
+      count = Copy();
+    }
+#else
+    count = Copy();
+#endif
+    if (count > 0) {
+      offset_ += count;
+      remaining_ -= count;
+      transferred_ += count;
+    } else if (count == 0) {
+      break;
+    } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return false;
+    } else if (errno != EINTR) {
+      *result = -errno;
+      return true;
+    }
+  }
+  *result = transferred_;
+  return true;
+}
+
+int64 FileTransfer::Copy() {
+  int64 size = Utils::Minimum<int64>(remaining_, kChunkSize);
+  uint8* buffer = static_cast<uint8*>(malloc(size));
+  int64 read = TEMP_FAILURE_RETRY(pread(file_, buffer, size, offset_));
+  int64 written = 0;
+  int error = errno;
+  while (written < read) {
+    int64 count = write(socket_, buffer + written, read - written);
+    if (count >= 0) {
+      written += count;
+    } else if (errno != EINTR) {
+      error = errno;
+      break;
+    }
+  }
+  free(buffer);
+  // The part of the chunk that was not written is read again next time.
+  if (read <= 0) {
+    errno = error;
+    return read;
+  }
+  if (written > 0) return written;
+  errno = error;
+  return -1;
+}
+
+#else  // defined(DARTINO_TARGET_OS_POSIX)
+
+EventHandler::Status FileTransfer::Start(FileTransfer* transfer) {
+  delete transfer;
+  return EventHandler::Status::ILLEGAL_STATE;
+}
+
+bool FileTransfer::Transfer(int64* result) {
+  UNIMPLEMENTED();
+  return true;
+}
+
+int64 FileTransfer::Copy() {
+  UNIMPLEMENTED();
+  return -1;
+}
+
+#endif  // defined(DARTINO_TARGET_OS_POSIX)
+
+}  // namespace dartino
@@ -0,0 +1,70 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_FILE_TRANSFER_H_
+#define SRC_VM_FILE_TRANSFER_H_
+
+#include "src/shared/globals.h"
+#include "src/vm/blocking_call_pool.h"
+#include "src/vm/event_handler.h"
+
+namespace dartino {
+
+// Transfers a range of a file to a non-blocking socket without copying the
+// data through the heap of a process. The event handler waits for the socket
+// to become writable, and the data is then transferred on the
+// BlockingCallPool, as reading the file blocks when it is not in the page
+// cache. Its result, the number of bytes transferred or a negative errno
+// value, is sent to [port]. Fewer bytes are transferred if the file ends
+// before the range does.
+//
+// On Linux the data goes through sendfile. Elsewhere, and for files that
+// sendfile does not support, it is copied with pread and write.
+//
+// The socket must not have a persistent registration, as the transfer
+// registers it for the next event only.
+class FileTransfer : public EventListener, public BlockingTask {
+ public:
+  static const int kChunkSize = 64 * KB;
+
+  FileTransfer(int socket, int file, int64 offset, int64 length, Port* port);
+  ~FileTransfer();
+
+  // Waits for [transfer] to be able to write and takes ownership of it.
+  // Returns ILLEGAL_STATE if the platform does not support transfers.
+  static EventHandler::Status Start(FileTransfer* transfer);
+
+  // Called on the event handler thread when the socket is writable. Queues
+  // the rest of the transfer on the BlockingCallPool.
+  void Send(int64 value);
+
+  // Transfers until the socket would block, and then waits for it again.
+  // Sends the result once the transfer is done.
+  void Perform();
+
+ private:
+  // Returns a new transfer of the remaining range, as the event handler and
+  // the BlockingCallPool delete the current one when it has run.
+  FileTransfer* Rest();
+
+  // Transfers as much as the socket accepts. Returns false if the socket
+  // is not writable, and otherwise stores the result of the transfer in
+  // [result].
+  bool Transfer(int64* result);
+  // Copies one chunk through a buffer. Returns the number of bytes written,
+  // 0 at the end of the file or -1 and sets errno.
+  int64 Copy();
+
+  const int socket_;
+  const int file_;
+  int64 offset_;
+  int64 remaining_;
+  int64 transferred_;
+  bool use_sendfile_;
+  Port* const port_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_FILE_TRANSFER_H_
@@ -13,7 +13,7 @@
 namespace dartino {
 
 Heap::Heap(RandomXorShift* random)
-    : random_(random), space_(NULL), foreign_memory_(0) {}
+    : random_(random), space_(NULL), foreign_memory_(0), mapped_memory_(0) {}
 
 OneSpaceHeap::OneSpaceHeap(RandomXorShift* random, int maximum_initial_size)
     : Heap(random) {
@@ -64,6 +64,7 @@ uword TwoSpaceHeap::MaxExpansion() {
 Heap::~Heap() {
   delete space_;
   ASSERT(foreign_memory_ == 0);
+  ASSERT(mapped_memory_ == 0);
 }
 
 TwoSpaceHeap::~TwoSpaceHeap() {
@@ -106,6 +106,15 @@ class Heap {
 
   uword used_foreign_memory() { return foreign_memory_; }
 
+  // Mapped files are backed by the file rather than by memory, so they are
+  // counted separately and do not count towards the allocation budget.
+  void AllocatedMappedMemory(uword size) { mapped_memory_ += size; }
+  void FreedMappedMemory(uword size) {
+    mapped_memory_ -= size;
+    ASSERT(static_cast<word>(mapped_memory_) >= 0);
+  }
+  uword used_mapped_memory() { return mapped_memory_; }
+
 #ifdef DEBUG
   // Used for debugging.  Give it an address, and it will tell you where there
   // are pointers to that address.  If the address is part of the heap it will
@@ -147,6 +156,8 @@ class Heap {
 
   // The number of bytes of foreign memory heap objects are holding on to.
   uword foreign_memory_;
+  // The number of bytes of mapped files heap objects are holding on to.
+  uword mapped_memory_;
 
 #ifdef DEBUG
   void IncrementNoAllocation() { ++no_allocation_; }
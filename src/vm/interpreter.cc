@@ -121,6 +121,7 @@ Process::StackCheckResult HandleStackOverflow(Process* process, int size) {
 
 void HandleGC(Process* process) {
   process->program()->CollectNewSpace();
+  process->program()->ShrinkSleepingStacks();
 
   // After a GC a lot of stacks might no longer have pointers to new space on
   // them. If so, the remembered set will no longer contain such a stack.
@@ -194,37 +195,52 @@ struct CatchBlock {
   int frame_size;
 };
 
-static uint8* FindCatchBlock(Stack* stack, int* stack_delta_result,
+static void LookupCatchBlock(uint8* bcp, CatchBlockCache::Entry* entry) {
+  entry->bcp = bcp;
+  entry->catch_bcp = NULL;
+  entry->frame_size = 0;
+
+  int offset = -1;
+  Function* function = Function::FromBytecodePointer(bcp, &offset);
+  // Skip if there are no catch blocks.
+  if (offset == -1) return;
+
+  uint8* catch_block_address = function->bytecode_address_for(offset);
+  int count = Utils::ReadInt32(catch_block_address);
+  const CatchBlock* block =
+      reinterpret_cast<const CatchBlock*>(catch_block_address + 4);
+  for (int i = 0; i < count; i++) {
+    uint8* start_address = function->bytecode_address_for(block->start);
+    uint8* end_address = function->bytecode_address_for(block->end);
+    // The first hit is the one we use (due to the order they are
+    // emitted).
+    if (start_address <= bcp && end_address > bcp) {
+      entry->catch_bcp = end_address;
+      entry->frame_size = block->frame_size;
+      return;
+    }
+    block++;
+  }
+}
+
+static uint8* FindCatchBlock(CatchBlockCache* cache, Stack* stack,
+                             int* stack_delta_result,
                              Object*** frame_pointer_result) {
   Frame frame(stack);
   while (frame.MovePrevious()) {
-    int offset = -1;
-    Function* function = frame.FunctionFromByteCodePointer(&offset);
+    uint8* bcp = frame.ByteCodePointer();
     // Skip frames with no byte code pointer / function.
-    if (function == NULL) continue;
+    if (bcp == NULL) continue;
 
-    // Skip if there are no catch blocks.
-    if (offset == -1) continue;
+    CatchBlockCache::Entry* entry = cache->Lookup(bcp);
+    if (entry->bcp != bcp) LookupCatchBlock(bcp, entry);
+    if (entry->catch_bcp == NULL) continue;
 
-    uint8* bcp = frame.ByteCodePointer();
-    uint8* catch_block_address = function->bytecode_address_for(offset);
-    int count = Utils::ReadInt32(catch_block_address);
-    const CatchBlock* block =
-        reinterpret_cast<const CatchBlock*>(catch_block_address + 4);
-    for (int i = 0; i < count; i++) {
-      uint8* start_address = function->bytecode_address_for(block->start);
-      uint8* end_address = function->bytecode_address_for(block->end);
-      // The first hit is the one we use (due to the order they are
-      // emitted).
-      if (start_address <= bcp && end_address > bcp) {
-        // Read the number of stack slots we need to pop.
-        int index = frame.FirstLocalIndex() - block->frame_size - 1;
-        *stack_delta_result = index - stack->top();
-        *frame_pointer_result = frame.FramePointer();
-        return end_address;
-      }
-      block++;
-    }
+    // Read the number of stack slots we need to pop.
+    int index = frame.FirstLocalIndex() - entry->frame_size - 1;
+    *stack_delta_result = index - stack->top();
+    *frame_pointer_result = frame.FramePointer();
+    return entry->catch_bcp;
   }
   return NULL;
 }
@@ -237,7 +253,8 @@ uint8* HandleThrow(Process* process, Object* exception, int* stack_delta_result,
     // If we find a handler, we do a 2nd pass, unwind all coroutine stacks
     // until the handler, make the unused coroutines/stacks GCable and return
     // the handling bcp.
-    uint8* catch_bcp = FindCatchBlock(current->stack(), stack_delta_result,
+    uint8* catch_bcp = FindCatchBlock(process->catch_block_cache(),
+                                      current->stack(), stack_delta_result,
                                       frame_pointer_result);
     if (catch_bcp != NULL) {
       Coroutine* unused = process->coroutine();
@@ -379,8 +396,13 @@ Function* HandleInvokeSelector(Process* process) {
 int HandleAtBytecode(Process* process, uint8* bcp, Object** sp) {
   // TODO(ajohnsen): Support validate stack.
 
-  // Always hit process-local/one-shot breakpoints first.
   ProcessDebugInfo* process_info = process->debug_info();
+  if (BytecodeProfiler::is_active() &&
+      (process_info == NULL || !process_info->is_at_breakpoint())) {
+    BytecodeProfiler::Record(process, bcp);
+  }
+
+  // Always hit process-local/one-shot breakpoints first.
   if (process_info != NULL) {
     // If resuming from a breakpoint, clear the breakpoint and ignore the call.
     if (process_info->is_at_breakpoint()) {
@@ -30,12 +30,17 @@ class Mailbox {
     ASSERT(last_message_.load() == NULL);
   }
 
-  void EnqueueEntry(MessageType* entry) {
-    ASSERT(entry->next() == NULL);
+  void EnqueueEntry(MessageType* entry) { EnqueueEntries(entry, entry); }
+
+  // Enqueue the chain of entries from [head] to [tail] using a single atomic
+  // update. The chain is linked newest first, so [tail] is the entry that
+  // will be received first.
+  void EnqueueEntries(MessageType* head, MessageType* tail) {
+    ASSERT(tail->next() == NULL);
     MessageType* last = last_message_;
     while (true) {
-      entry->set_next(last);
-      if (last_message_.compare_exchange_weak(last, entry)) break;
+      tail->set_next(last);
+      if (last_message_.compare_exchange_weak(last, head)) break;
     }
   }
 
@@ -10,6 +10,7 @@ namespace dartino {
 ExitReference::ExitReference(Object* message) : message_(message) {}
 
 Message::~Message() {
+  port_->DecrementQueueLength();
   port_->DecrementRef();
   if (kind() == EXIT) {
     ExitReference* ref = reinterpret_cast<ExitReference*>(value());
@@ -32,6 +33,23 @@ Message* Message::NewImmutableMessage(Port* port, Object* message) {
   return NULL;
 }
 
+MessageCache::~MessageCache() {
+  while (free_list_ != NULL) {
+    FreeEntry* next = free_list_->next;
+    ::operator delete(free_list_);
+    free_list_ = next;
+  }
+}
+
+Message* MessageCache::NewImmutableMessage(Port* port, Object* message) {
+  uint64 address = reinterpret_cast<uint64>(message);
+  if (!message->IsHeapObject()) {
+    return New(port, address, 0, Message::IMMEDIATE);
+  }
+  ASSERT(message->IsImmutable());
+  return New(port, address, 0, Message::IMMUTABLE_OBJECT);
+}
+
 void MessageMailbox::Enqueue(Port* port, Object* message) {
   EnqueueEntry(Message::NewImmutableMessage(port, message));
 }
@@ -5,6 +5,8 @@
 #ifndef SRC_VM_MESSAGE_MAILBOX_H_
 #define SRC_VM_MESSAGE_MAILBOX_H_
 
+#include <new>
+
 #include "src/shared/globals.h"
 #include "src/shared/atomic.h"
 
@@ -39,6 +41,8 @@ class Message : public MailboxMessage<Message> {
     FOREIGN_FINALIZED,
     PROCESS_DEATH_SIGNAL,
     EXIT,
+    // A copy of a mutable object graph that only the receiver references.
+    COPIED_OBJECT,
   };
 
   Message(Port* port, uint64 value, int size, Kind kind)
@@ -46,12 +50,17 @@ class Message : public MailboxMessage<Message> {
         value_(value),
         kind_and_size_(KindField::encode(kind) | SizeField::encode(size)) {
     port_->IncrementRef();
+    port_->IncrementQueueLength();
   }
 
   ~Message();
 
   static Message* NewImmutableMessage(Port* port, Object* message);
 
+  static bool IsValidSize(word size) {
+    return size >= 0 && SizeField::is_valid(size);
+  }
+
   Port* port() const { return port_; }
   uint64 value() const { return value_; }
   int size() const { return SizeField::decode(kind_and_size_); }
@@ -70,6 +79,7 @@ class Message : public MailboxMessage<Message> {
   void VisitPointers(PointerVisitor* visitor) {
     switch (kind()) {
       case IMMUTABLE_OBJECT:
+      case COPIED_OBJECT:
         visitor->Visit(reinterpret_cast<Object**>(&value_));
         break;
       case EXIT: {
@@ -92,8 +102,65 @@ class Message : public MailboxMessage<Message> {
   const int32 kind_and_size_;
 };
 
+// Free list of message memory owned by a process. Messages sent by the
+// process are allocated from its cache and the messages it receives are
+// returned to it, so processes exchanging messages keep reusing the same
+// memory instead of going through the allocator for every send. Only the
+// thread currently interpreting the owning process uses the cache.
+class MessageCache {
+ public:
+  static const int kMaxSize = 64;
+
+  MessageCache() : free_list_(NULL), size_(0) {}
+  ~MessageCache();
+
+  Message* New(Port* port, uint64 value, int size, Message::Kind kind) {
+    void* memory;
+    if (free_list_ != NULL) {
+      memory = free_list_;
+      free_list_ = free_list_->next;
+      size_--;
+    } else {
+      memory = ::operator new(sizeof(Message));
+    }
+    return new (memory) Message(port, value, size, kind);
+  }
+
+  Message* NewImmutableMessage(Port* port, Object* message);
+
+  // Destructs [message] and keeps its memory for reuse. Messages from the
+  // cache can be freed with plain delete and vice versa.
+  void Delete(Message* message) {
+    message->~Message();
+    if (size_ == kMaxSize) {
+      ::operator delete(message);
+      return;
+    }
+    FreeEntry* entry = reinterpret_cast<FreeEntry*>(message);
+    entry->next = free_list_;
+    free_list_ = entry;
+    size_++;
+  }
+
+ private:
+  struct FreeEntry {
+    FreeEntry* next;
+  };
+
+  FreeEntry* free_list_;
+  int size_;
+};
+
 class MessageMailbox : public Mailbox<Message> {
  public:
+  // Advance the current message, returning its memory to [cache].
+  void AdvanceCurrentMessage(MessageCache* cache) {
+    ASSERT(current_message_ != NULL);
+    Message* temp = current_message_;
+    current_message_ = current_message_->next();
+    cache->Delete(temp);
+  }
+
   void Enqueue(Port* port, Object* message);
   void EnqueueLargeInteger(Port* port, int64 value);
   void EnqueueForeign(Port* port, void* foreign, int size, bool finalized);
@@ -15,12 +15,15 @@
 #include "src/shared/platform.h"
 
 #include "src/vm/event_handler.h"
+#include "src/vm/file_transfer.h"
 #include "src/vm/interpreter.h"
 #include "src/vm/native_interpreter.h"
 #include "src/vm/port.h"
 #include "src/vm/process.h"
+#include "src/vm/resolver.h"
 #include "src/vm/scheduler.h"
 #include "src/vm/session.h"
+#include "src/vm/socket_stream.h"
 #include "src/vm/unicode.h"
 
 #include "third_party/double-conversion/src/double-conversion.h"
@@ -1099,7 +1102,7 @@ BEGIN_LEAF_NATIVE(CoroutineCurrent) { return process->coroutine(); }
 END_NATIVE()
 
 BEGIN_LEAF_NATIVE(CoroutineNewStack) {
-  Object* object = process->NewStack(256);
+  Object* object = process->NewCoroutineStack();
   if (object->IsFailure()) return object;
   Instance* coroutine = Instance::cast(arguments[0]);
   Instance* entry = Instance::cast(arguments[1]);
@@ -1139,6 +1142,18 @@ BEGIN_LEAF_NATIVE(CoroutineNewStack) {
 }
 END_NATIVE()
 
+BEGIN_LEAF_NATIVE(CoroutineRecycleStack) {
+  // The stack of the running coroutine is still in use.
+  Coroutine* coroutine = Coroutine::cast(arguments[0]);
+  if (coroutine == process->coroutine() || !coroutine->has_stack()) {
+    return process->program()->null_object();
+  }
+  process->RecycleStack(coroutine->stack());
+  coroutine->set_stack(process->program()->null_object());
+  return process->program()->null_object();
+}
+END_NATIVE()
+
 BEGIN_LEAF_NATIVE(StopwatchFrequency) { return Smi::FromWord(1000000); }
 END_NATIVE()
 
@@ -1483,11 +1498,240 @@ BEGIN_LEAF_NATIVE(SystemEventHandlerAdd) {
   Object* flags_arg = arguments[2];
   if (!flags_arg->IsSmi()) return Failure::wrong_argument_type();
   int flags = Smi::cast(flags_arg)->value();
-  return EventHandler::GlobalInstance()
+  return EventHandler::ForId(id)
       ->AddPortListener(process, id, port, flags);
 }
 END_NATIVE()
 
+static EventRegistration* EventRegistrationFromHandle(Object* handle) {
+  if (!handle->IsSmi()) return NULL;
+  return EventHandler::LookupHandle(Smi::cast(handle)->value());
+}
+
+BEGIN_LEAF_NATIVE(SystemEventHandlerRegister) {
+  Object* id = arguments[0];
+  if (!arguments[1]->IsPort()) return Failure::wrong_argument_type();
+  Port* port = Port::FromDartObject(arguments[1]);
+  if (port == NULL) return Failure::illegal_state();
+  EventRegistration* registration = new EventRegistration(port);
+  EventHandler* event_handler = EventHandler::ForId(id);
+  switch (event_handler->AddRegistration(id, registration)) {
+    case EventHandler::Status::OK:
+      break;
+    case EventHandler::Status::WRONG_ARGUMENT_TYPE:
+      delete registration;
+      return Failure::wrong_argument_type();
+    case EventHandler::Status::ILLEGAL_STATE:
+      delete registration;
+      return Failure::illegal_state();
+    case EventHandler::Status::INDEX_OUT_OF_BOUNDS:
+      delete registration;
+      return Failure::index_out_of_bounds();
+  }
+  return Smi::FromWord(EventHandler::NewHandle(registration));
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SystemEventHandlerWait) {
+  if (!arguments[0]->IsSmi() || !arguments[1]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  EventRegistration* registration = EventRegistrationFromHandle(arguments[0]);
+  if (registration == NULL) return Failure::illegal_state();
+  return Smi::FromWord(registration->Wait(Smi::cast(arguments[1])->value()));
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SystemEventHandlerMarkReady) {
+  if (!arguments[0]->IsSmi() || !arguments[1]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  EventRegistration* registration = EventRegistrationFromHandle(arguments[0]);
+  if (registration == NULL) return Failure::illegal_state();
+  registration->MarkReady(Smi::cast(arguments[1])->value());
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SystemEventHandlerUnregister) {
+  if (!arguments[0]->IsSmi()) return Failure::wrong_argument_type();
+  EventRegistration* registration =
+      EventHandler::ReleaseHandle(Smi::cast(arguments[0])->value());
+  if (registration == NULL) return Failure::illegal_state();
+  EventHandler::ForFd(registration->id())->RemoveRegistration(registration);
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SystemEventHandlerSubmitIo) {
+  if (!arguments[0]->IsSmi() || !arguments[1]->IsSmi() ||
+      !arguments[3]->IsSmi() || !arguments[5]->IsPort()) {
+    return Failure::wrong_argument_type();
+  }
+  word kind = Smi::cast(arguments[0])->value();
+  word fd = Smi::cast(arguments[1])->value();
+  word length = Smi::cast(arguments[3])->value();
+  if (kind < 0 || kind >= IoOperation::NUMBER_OF_KINDS || fd < 0 ||
+      length < 0) {
+    return Failure::index_out_of_bounds();
+  }
+  void* buffer = reinterpret_cast<void*>(AsForeignWord(arguments[2]));
+  int64 offset = AsForeignInt64(arguments[4]);
+  Port* port = Port::FromDartObject(arguments[5]);
+  if (port == NULL) return Failure::illegal_state();
+  IoOperation* operation =
+      new IoOperation(static_cast<IoOperation::Kind>(kind), fd, buffer,
+                      length, offset, port);
+  switch (EventHandler::ForFd(fd)->SubmitIo(operation)) {
+    case EventHandler::Status::OK:
+      return process->program()->true_object();
+    case EventHandler::Status::INDEX_OUT_OF_BOUNDS:
+      return Failure::index_out_of_bounds();
+    default:
+      return Failure::illegal_state();
+  }
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SystemEventHandlerSendFile) {
+  if (!arguments[0]->IsSmi() || !arguments[1]->IsSmi() ||
+      !arguments[4]->IsPort()) {
+    return Failure::wrong_argument_type();
+  }
+  word socket = Smi::cast(arguments[0])->value();
+  word file = Smi::cast(arguments[1])->value();
+  int64 offset = AsForeignInt64(arguments[2]);
+  int64 length = AsForeignInt64(arguments[3]);
+  if (socket < 0 || file < 0 || offset < 0 || length < 0) {
+    return Failure::index_out_of_bounds();
+  }
+  Port* port = Port::FromDartObject(arguments[4]);
+  if (port == NULL) return Failure::illegal_state();
+  FileTransfer* transfer = new FileTransfer(socket, file, offset, length, port);
+  switch (FileTransfer::Start(transfer)) {
+    case EventHandler::Status::OK:
+      return process->program()->true_object();
+    case EventHandler::Status::INDEX_OUT_OF_BOUNDS:
+      return Failure::index_out_of_bounds();
+    default:
+      return Failure::illegal_state();
+  }
+}
+END_NATIVE()
+
+static SocketStream* SocketStreamFromHandle(Object* handle) {
+  EventRegistration* registration = EventRegistrationFromHandle(handle);
+  if (registration == NULL || !registration->IsSocketStream()) return NULL;
+  return static_cast<SocketStream*>(registration);
+}
+
+BEGIN_LEAF_NATIVE(SocketStreamOpen) {
+  Object* id = arguments[0];
+  if (!arguments[1]->IsPort() || !arguments[2]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  word capacity = Smi::cast(arguments[2])->value();
+  if (capacity < SocketStream::kMinCapacity ||
+      capacity > SocketStream::kMaxCapacity ||
+      !Utils::IsPowerOfTwo(capacity)) {
+    return Failure::index_out_of_bounds();
+  }
+  Port* port = Port::FromDartObject(arguments[1]);
+  if (port == NULL) return Failure::illegal_state();
+  SocketStream* stream = new SocketStream(port, static_cast<int>(capacity));
+  switch (EventHandler::ForId(id)->AddRegistration(id, stream)) {
+    case EventHandler::Status::OK:
+      break;
+    case EventHandler::Status::WRONG_ARGUMENT_TYPE:
+      delete stream;
+      return Failure::wrong_argument_type();
+    case EventHandler::Status::ILLEGAL_STATE:
+      delete stream;
+      return Failure::illegal_state();
+    case EventHandler::Status::INDEX_OUT_OF_BOUNDS:
+      delete stream;
+      return Failure::index_out_of_bounds();
+  }
+  return Smi::FromWord(EventHandler::NewHandle(stream));
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SocketStreamBuffer) {
+  if (!arguments[0]->IsSmi()) return Failure::wrong_argument_type();
+  SocketStream* stream = SocketStreamFromHandle(arguments[0]);
+  if (stream == NULL) return Failure::illegal_state();
+  return process->ToInteger(reinterpret_cast<word>(stream->buffer()));
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SocketStreamAvailable) {
+  if (!arguments[0]->IsSmi()) return Failure::wrong_argument_type();
+  SocketStream* stream = SocketStreamFromHandle(arguments[0]);
+  if (stream == NULL) return Failure::illegal_state();
+  return Smi::FromWord(stream->Available());
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SocketStreamRead) {
+  if (!arguments[0]->IsSmi() || !arguments[2]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  SocketStream* stream = SocketStreamFromHandle(arguments[0]);
+  if (stream == NULL) return Failure::illegal_state();
+  uint8* destination = reinterpret_cast<uint8*>(AsForeignWord(arguments[1]));
+  word length = Smi::cast(arguments[2])->value();
+  if (length < 0) return Failure::index_out_of_bounds();
+  return Smi::FromWord(stream->Read(destination, length));
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SocketStreamConsume) {
+  if (!arguments[0]->IsSmi() || !arguments[1]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  SocketStream* stream = SocketStreamFromHandle(arguments[0]);
+  if (stream == NULL) return Failure::illegal_state();
+  word length = Smi::cast(arguments[1])->value();
+  if (length < 0 || length > stream->Available()) {
+    return Failure::index_out_of_bounds();
+  }
+  stream->Consume(length);
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SocketStreamWrite) {
+  if (!arguments[0]->IsSmi() || !arguments[2]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  SocketStream* stream = SocketStreamFromHandle(arguments[0]);
+  if (stream == NULL) return Failure::illegal_state();
+  word* iovecs = reinterpret_cast<word*>(AsForeignWord(arguments[1]));
+  word count = Smi::cast(arguments[2])->value();
+  if (count < 0 || count > SocketStream::kMaxIovecs) {
+    return Failure::index_out_of_bounds();
+  }
+  return process->ToInteger(stream->Write(iovecs, static_cast<int>(count)));
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(SystemResolverLookup) {
+  Port* port = NULL;
+  if (arguments[1]->IsPort()) {
+    port = Port::FromDartObject(arguments[1]);
+  } else if (arguments[1] != process->program()->null_object()) {
+    return Failure::wrong_argument_type();
+  }
+  char* host = AsForeignString(arguments[0]);
+  if (host == NULL) return Failure::wrong_argument_type();
+  int64 result;
+  bool cached = Resolver::GlobalInstance()->Lookup(host, port, &result);
+  free(host);
+  if (!cached) return process->program()->null_object();
+  return process->ToInteger(result);
+}
+END_NATIVE()
+
 BEGIN_LEAF_NATIVE(IsImmutable) {
   Object* o = arguments[0];
   return ToBool(process, o->IsImmutable());
@@ -1528,19 +1772,18 @@ END_NATIVE()
 BEGIN_LEAF_NATIVE(TimerScheduleTimeout) {
   int64 timeout = AsForeignInt64(arguments[0]);
   Port* port = Port::FromDartObject(arguments[1]);
-  EventHandler::GlobalInstance()->ScheduleTimeout(timeout, port);
+  EventHandler::ForPort(port)->ScheduleTimeout(timeout, port);
   return process->program()->null_object();
 }
 END_NATIVE()
 
 BEGIN_LEAF_NATIVE(EventHandlerSleep) {
   int64 arg = AsForeignInt64(arguments[0]);
-  // Adding one (1) if the sleep is not for 0 ms. This ensures that the
-  // sleep will last at least the provided number of milliseconds.
-  int64 offset = arg == 0 ? 0 : 1;
-  int64 timeout = arg + Platform::GetMicroseconds() / 1000 + offset;
+  // Timeouts never expire early, so the sleep lasts at least the provided
+  // number of milliseconds.
+  int64 timeout = Platform::GetMicroseconds() + arg * 1000;
   Port* port = Port::FromDartObject(arguments[1]);
-  EventHandler::GlobalInstance()->ScheduleTimeout(timeout, port);
+  EventHandler::ForPort(port)->ScheduleTimeout(timeout, port);
   return process->program()->null_object();
 }
 END_NATIVE()
@@ -710,6 +710,7 @@ class Instance : public HeapObject {
   inline void SetFlagsBits(uint32 bits);
 
   friend class Heap;
+  friend class ObjectGraphCopier;
   friend class TwoSpaceHeap;
   friend class Program;
 
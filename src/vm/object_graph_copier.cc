@@ -0,0 +1,107 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/object_graph_copier.h"
+
+#include <string.h>
+
+#include "src/vm/gc_metadata.h"
+#include "src/vm/object.h"
+#include "src/vm/process.h"
+
+namespace dartino {
+
+Object* ObjectGraphCopier::Copy(Object* object) {
+  Object* result = Visit(object);
+  if (result->IsFailure()) return result;
+  // The fields of the originals are visited in order, so [originals_] also
+  // serves as the worklist.
+  for (size_t i = 0; i < originals_.size(); i++) {
+    HeapObject* original = originals_[i];
+    if (original->IsArray()) {
+      Array* array = Array::cast(original);
+      for (int j = 0; j < array->length(); j++) {
+        result = Visit(array->get(j));
+        if (result->IsFailure()) return result;
+      }
+    } else if (original->IsInstance()) {
+      Instance* instance = Instance::cast(original);
+      int fields = instance->get_class()->NumberOfInstanceFields();
+      for (int j = 0; j < fields; j++) {
+        result = Visit(instance->GetInstanceField(j));
+        if (result->IsFailure()) return result;
+      }
+    }
+  }
+
+  process_->RegisterProcessAllocation();
+  result = process_->heap()->Allocate(size_);
+  if (result->IsFailure()) return result;
+  uword address = HeapObject::cast(result)->address();
+  // Large graphs are allocated in old-space, where every object start has
+  // to be recorded for the remembered-set scanner.
+  bool in_old_space = !process_->heap()->space()->Includes(address);
+
+  // Copy the objects verbatim, which keeps their lengths and identity hash
+  // codes, and fix up their fields once every copy is known.
+  for (size_t i = 0; i < originals_.size(); i++) {
+    HeapObject* original = originals_[i];
+    uword size = original->Size();
+    if (in_old_space) GCMetadata::RecordStart(address);
+    memcpy(reinterpret_cast<void*>(address),
+           reinterpret_cast<void*>(original->address()), size);
+    forwarding_[original] = HeapObject::FromAddress(address);
+    address += size;
+  }
+  for (size_t i = 0; i < originals_.size(); i++) {
+    HeapObject* copy = forwarding_[originals_[i]];
+    if (copy->IsArray()) {
+      Array* array = Array::cast(copy);
+      for (int j = 0; j < array->length(); j++) {
+        array->set(j, Forward(array->get(j)));
+      }
+    } else if (copy->IsInstance()) {
+      Instance* instance = Instance::cast(copy);
+      int fields = instance->get_class()->NumberOfInstanceFields();
+      for (int j = 0; j < fields; j++) {
+        instance->SetInstanceField(j, Forward(instance->GetInstanceField(j)));
+      }
+    }
+  }
+  return Forward(object);
+}
+
+Object* ObjectGraphCopier::Visit(Object* object) {
+  if (object->IsImmutable()) return object;
+
+  HeapObject* original = HeapObject::cast(object);
+  if (forwarding_.Find(original) != forwarding_.End()) return object;
+
+  if (object->IsInstance()) {
+    Class* klass = Instance::cast(object)->get_class();
+    // Coroutines, and foreign memory which owns native memory, cannot be
+    // duplicated.
+    Program* program = process_->program();
+    if (klass->instance_format().marker() != InstanceFormat::NO_MARKER ||
+        klass->IsSubclassOf(program->foreign_memory_class())) {
+      return Failure::wrong_argument_type();
+    }
+  } else if (!object->IsArray() && !object->IsByteArray()) {
+    return Failure::wrong_argument_type();
+  }
+
+  forwarding_[original] = NULL;
+  originals_.PushBack(original);
+  size_ += original->Size();
+  return object;
+}
+
+Object* ObjectGraphCopier::Forward(Object* object) {
+  if (object->IsImmutable()) return object;
+  HeapObject* copy = forwarding_[HeapObject::cast(object)];
+  ASSERT(copy != NULL);
+  return copy;
+}
+
+}  // namespace dartino
@@ -0,0 +1,56 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_OBJECT_GRAPH_COPIER_H_
+#define SRC_VM_OBJECT_GRAPH_COPIER_H_
+
+#include "src/shared/globals.h"
+
+#include "src/vm/hash_map.h"
+#include "src/vm/vector.h"
+
+namespace dartino {
+
+class HeapObject;
+class Object;
+class Process;
+
+// Copies a graph of mutable objects so that it can be handed to another
+// process. Immutable objects are shared rather than copied. A forwarding
+// table maps every copied object to its copy, which preserves sharing and
+// cycles in the graph. Copied instances keep their identity hash codes, so
+// hash based collections in the copy stay valid.
+//
+// The graph is measured first and copied into a single allocation. Graphs
+// too large for new-space are allocated in old-space, like other large
+// objects.
+//
+// Only instances, arrays and byte arrays are copied. Foreign memory and
+// other objects tied to native resources cannot be copied.
+class ObjectGraphCopier {
+ public:
+  explicit ObjectGraphCopier(Process* process)
+      : process_(process), size_(0) {}
+
+  // Returns the copy of [object]. Returns a wrong argument type failure if
+  // the graph cannot be copied, or a retry after GC failure if the copy
+  // must be restarted after a garbage collection.
+  Object* Copy(Object* object);
+
+ private:
+  // Adds [object] to [originals_] unless it is immutable or already added.
+  // Returns a failure if the object cannot be copied.
+  Object* Visit(Object* object);
+  Object* Forward(Object* object);
+
+  Process* process_;
+  HashMap<HeapObject*, HeapObject*> forwarding_;
+  // The objects to copy, in the order of their copies.
+  Vector<HeapObject*> originals_;
+  uword size_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_OBJECT_GRAPH_COPIER_H_
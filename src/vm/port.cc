@@ -9,6 +9,7 @@
 #include "src/vm/interpreter.h"
 #include "src/vm/natives.h"
 #include "src/vm/object.h"
+#include "src/vm/object_graph_copier.h"
 #include "src/vm/process.h"
 
 namespace dartino {
@@ -17,6 +18,9 @@ Port::Port(Process* process, Instance* channel)
     : process_(process),
       channel_(channel),
       ref_count_(1),
+      queue_length_(0),
+      capacity_(0),
+      overflow_(kBlock),
       spinlock_(),
       next_(process->ports()) {
   ASSERT(process != NULL);
@@ -130,13 +134,15 @@ BEGIN_NATIVE(PortSend) {
 
   Port* port = Port::FromDartObject(instance);
   if (port == NULL) return Failure::illegal_state();
+  if (port->IsFull()) return Failure::index_out_of_bounds();
 
   // We want to avoid holding a spinlock while doing an allocation, so:
   //    * we do an early return if the destination process is not there
   //    * we allocate (and possibly free) the message outside of the spinlock
   //      region.
   if (port->process() != NULL) {
-    Message* entry = Message::NewImmutableMessage(port, message);
+    MessageCache* cache = process->message_cache();
+    Message* entry = cache->NewImmutableMessage(port, message);
 
     port->Lock();
     Process* port_process = port->process();
@@ -153,12 +159,191 @@ BEGIN_NATIVE(PortSend) {
     }
     port->Unlock();
 
-    if (entry != NULL) delete entry;
+    if (entry != NULL) cache->Delete(entry);
   }
   return process->program()->null_object();
 }
 END_NATIVE()
 
+BEGIN_NATIVE(PortSendList) {
+  Instance* instance = Instance::cast(arguments[0]);
+
+  Object* list = Instance::cast(arguments[1])->GetInstanceField(0);
+  if (!list->IsArray() || !arguments[2]->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  Array* messages = Array::cast(list);
+  int count = Smi::cast(arguments[2])->value();
+  if (count < 0 || count > messages->length()) {
+    return Failure::index_out_of_bounds();
+  }
+  for (int i = 0; i < count; i++) {
+    if (!messages->get(i)->IsImmutable()) return Failure::wrong_argument_type();
+  }
+
+  Port* port = Port::FromDartObject(instance);
+  if (port == NULL) return Failure::illegal_state();
+  if (port->IsFull()) return Failure::index_out_of_bounds();
+
+  // Like PortSend, but the messages are chained up front and enqueued with a
+  // single atomic update and a single wakeup of the receiver.
+  if (count > 0 && port->process() != NULL) {
+    MessageCache* cache = process->message_cache();
+    Message* head = NULL;
+    Message* tail = NULL;
+    for (int i = 0; i < count; i++) {
+      Message* entry = cache->NewImmutableMessage(port, messages->get(i));
+      entry->set_next(head);
+      if (tail == NULL) tail = entry;
+      head = entry;
+    }
+
+    port->Lock();
+    Process* port_process = port->process();
+    if (port_process != NULL) {
+      port_process->mailbox()->EnqueueEntries(head, tail);
+      head = NULL;
+
+      if (port_process != process) {
+        return reinterpret_cast<Object*>(port);
+      }
+    }
+    port->Unlock();
+
+    while (head != NULL) {
+      Message* next = head->next();
+      cache->Delete(head);
+      head = next;
+    }
+  }
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_NATIVE(PortSendCopy) {
+  Instance* instance = Instance::cast(arguments[0]);
+  Port* port = Port::FromDartObject(instance);
+  if (port == NULL) return Failure::illegal_state();
+  if (port->IsFull()) return Failure::index_out_of_bounds();
+  if (port->process() == NULL) return process->program()->null_object();
+
+  Object* message = arguments[1];
+  Message::Kind kind = Message::IMMUTABLE_OBJECT;
+  if (!message->IsImmutable()) {
+    ObjectGraphCopier copier(process);
+    message = copier.Copy(message);
+    if (message->IsFailure()) return message;
+    kind = Message::COPIED_OBJECT;
+  }
+
+  uint64 address = reinterpret_cast<uint64>(message);
+  MessageCache* cache = process->message_cache();
+  Message* entry = cache->New(port, address, 0, kind);
+
+  port->Lock();
+  Process* port_process = port->process();
+  if (port_process != NULL) {
+    port_process->mailbox()->EnqueueEntry(entry);
+    if (port_process != process) return reinterpret_cast<Object*>(port);
+    entry = NULL;
+  }
+  port->Unlock();
+
+  if (entry != NULL) cache->Delete(entry);
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_NATIVE(PortTransfer) {
+  Instance* instance = Instance::cast(arguments[0]);
+  Program* program = process->program();
+
+  Object* argument = arguments[1];
+  if (!argument->IsInstance() ||
+      Instance::cast(argument)->get_class() !=
+          program->foreign_memory_class()) {
+    return Failure::wrong_argument_type();
+  }
+  Instance* memory = Instance::cast(argument);
+  Object* length = memory->GetInstanceField(2);
+  if (!length->IsSmi() || !Message::IsValidSize(Smi::cast(length)->value())) {
+    return Failure::wrong_argument_type();
+  }
+
+  Port* port = Port::FromDartObject(instance);
+  if (port == NULL) return Failure::illegal_state();
+  if (port->IsFull()) return Failure::index_out_of_bounds();
+
+  int size = Smi::cast(length)->value();
+  bool finalized = memory->GetInstanceField(3) == program->true_object();
+  Message::Kind kind =
+      finalized ? Message::FOREIGN_FINALIZED : Message::FOREIGN;
+  MessageCache* cache = process->message_cache();
+  Message* entry = cache->New(port, memory->GetConsecutiveSmis(0), size, kind);
+
+  port->Lock();
+  Process* port_process = port->process();
+  if (port_process == NULL) {
+    // Keep the memory with the sender rather than leaking it.
+    port->Unlock();
+    cache->Delete(entry);
+    return Failure::illegal_state();
+  }
+  port_process->mailbox()->EnqueueEntry(entry);
+
+  // The receiver now owns the memory, so empty the sender's view of it. Its
+  // finalizer, if any, stays registered but has nothing left to free.
+  memory->SetConsecutiveSmis(0, 0);
+  memory->SetInstanceField(2, Smi::FromWord(0));
+  memory->SetInstanceField(3, program->false_object());
+  if (finalized) process->heap()->FreedForeignMemory(size);
+
+  if (port_process != process) return reinterpret_cast<Object*>(port);
+  port->Unlock();
+  return program->null_object();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(PortSetCapacity) {
+  Port* port = Port::FromDartObject(arguments[0]);
+  if (port == NULL) return Failure::illegal_state();
+  Object* capacity = arguments[1];
+  Object* overflow = arguments[2];
+  if (!capacity->IsSmi() || !overflow->IsSmi()) {
+    return Failure::wrong_argument_type();
+  }
+  word value = Smi::cast(capacity)->value();
+  word policy = Smi::cast(overflow)->value();
+  if (value < 0 || value > Smi::kMaxPortableValue || policy < Port::kBlock ||
+      policy > Port::kFail) {
+    return Failure::index_out_of_bounds();
+  }
+  port->SetCapacity(value, static_cast<Port::OverflowPolicy>(policy));
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(PortCapacity) {
+  Port* port = Port::FromDartObject(arguments[0]);
+  if (port == NULL) return Failure::illegal_state();
+  return Smi::FromWord(port->capacity());
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(PortOverflow) {
+  Port* port = Port::FromDartObject(arguments[0]);
+  if (port == NULL) return Failure::illegal_state();
+  return Smi::FromWord(port->overflow());
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(PortQueueLength) {
+  Port* port = Port::FromDartObject(arguments[0]);
+  if (port == NULL) return Failure::illegal_state();
+  return Smi::FromWord(port->queue_length());
+}
+END_NATIVE()
+
 BEGIN_NATIVE(PortSendExit) {
   Instance* instance = Instance::cast(arguments[0]);
   Port* port = Port::FromDartObject(instance);
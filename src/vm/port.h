@@ -21,6 +21,10 @@ class Process;
 
 class Port {
  public:
+  // What happens to messages sent to a full port. This enum needs to be kept
+  // in sync with the PortOverflow enum in lib/dartino/dartino.dart.
+  enum OverflowPolicy { kBlock, kDropOldest, kFail };
+
   Port(Process* process, Instance* channel);
 
   static Port* FromDartObject(Object* dart_port);
@@ -38,6 +42,36 @@ class Port {
 
   Spinlock* spinlock() { return &spinlock_; }
 
+  // Bound the number of messages queued for the owning process. Called by
+  // the owner before the port is shared. A capacity of zero means that the
+  // port is unbounded.
+  void SetCapacity(int capacity, OverflowPolicy overflow) {
+    capacity_ = capacity;
+    overflow_ = overflow;
+  }
+  int capacity() const { return capacity_; }
+  OverflowPolicy overflow() const { return overflow_; }
+
+  // The number of messages sent through this port that the owning process
+  // has not yet received. These functions are thread safe.
+  int queue_length() const { return queue_length_; }
+  void IncrementQueueLength() { queue_length_++; }
+  void DecrementQueueLength() { queue_length_--; }
+
+  // Tells whether senders must be turned away. Concurrent senders can push
+  // the queue slightly past the capacity.
+  bool IsFull() const {
+    return capacity_ > 0 && overflow_ != kDropOldest &&
+           queue_length_ >= capacity_;
+  }
+
+  // Tells whether the oldest message queued through a drop-oldest port must
+  // be dropped instead of received.
+  bool IsOverflowing() const {
+    return capacity_ > 0 && overflow_ == kDropOldest &&
+           queue_length_ > capacity_;
+  }
+
   // Increment the ref count. This function is thread safe.
   void IncrementRef();
 
@@ -64,6 +98,9 @@ class Port {
   Process* process_;
   Instance* channel_;
   Atomic<int> ref_count_;
+  Atomic<int> queue_length_;
+  int capacity_;
+  OverflowPolicy overflow_;
   Spinlock spinlock_;
   // The ports are in a list in the process so that we can GC the channel
   // pointer.
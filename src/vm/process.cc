@@ -48,6 +48,10 @@ Process::Process(Program* program, Process* parent)
       parent_(parent),
       errno_cache_(0),
       debug_info_(NULL),
+      bytecode_counters_(NULL),
+      function_counters_(NULL),
+      catch_block_cache_(NULL),
+      stack_pool_size_(0),
       scheduler_(NULL)
 #ifdef DEBUG
       ,
@@ -104,6 +108,8 @@ Process::~Process() {
   if (signal != NULL) Signal::DecrementRef(signal);
 
   delete debug_info_;
+  delete function_counters_;
+  delete catch_block_cache_;
   for (int i = 0; i < arguments_.length(); i++) {
     arguments_[i].Delete();
   }
@@ -111,8 +117,7 @@ Process::~Process() {
 }
 
 void Process::Cleanup(Signal::Kind kind) {
-  EventHandler* event_handler = EventHandler::GlobalInstance();
-  event_handler->ReceiverForPortsDied(ports_);
+  EventHandler::ReceiverForPortsDiedOnAllShards(ports_);
 
   // Clear out the process pointer from all the ports.
   while (ports_ != NULL) {
@@ -175,10 +180,17 @@ Process::StackCheckResult Process::HandleStackOverflow(int addition) {
     }
   }
 
+  // Grow the stack geometrically so deep recursion only copies the frames a
+  // logarithmic number of times.
+  int length = stack()->length();
   int size_increase = Utils::RoundUpToPowerOfTwo(addition);
-  size_increase = Utils::Maximum(256, size_increase);
-  int new_size = stack()->length() + size_increase;
-  if (new_size > Platform::MaxStackSizeInWords()) return kStackCheckOverflow;
+  size_increase = Utils::Maximum(Utils::Maximum(256, length), size_increase);
+  int new_size = length + size_increase;
+  int max_size = Platform::MaxStackSizeInWords();
+  if (new_size > max_size) {
+    if (length + addition > max_size) return kStackCheckOverflow;
+    new_size = max_size;
+  }
 
   Object* new_stack_object = NewStack(new_size);
   if (new_stack_object->IsRetryAfterGCFailure()) {
@@ -194,9 +206,31 @@ Process::StackCheckResult Process::HandleStackOverflow(int addition) {
     }
   }
 
+  ReplaceStack(Stack::cast(new_stack_object));
+  return kStackCheckContinue;
+}
+
+void Process::ShrinkStack() {
+  if (state() != kSleeping || is_debugging()) return;
+  if (!coroutine_->has_stack()) return;
+
+  // Keep at least as much free space as is in use, so a process that keeps
+  // going back and forth around the same depth does not grow again right
+  // after it wakes up.
+  int length = stack()->length();
+  word height = length - stack()->top();
+  int new_size = Utils::RoundUpToPowerOfTwo(2 * height);
+  new_size = Utils::Maximum(kInitialStackSize, new_size);
+  if (new_size * 4 > length) return;
+
+  Object* new_stack_object = NewStack(new_size);
+  if (new_stack_object->IsFailure()) return;
+  ReplaceStack(Stack::cast(new_stack_object));
+}
+
+void Process::ReplaceStack(Stack* new_stack) {
   NoAllocationScope scope(heap());  // Protect new_stack.
 
-  Stack* new_stack = Stack::cast(new_stack_object);
   word height = stack()->length() - stack()->top();
   ASSERT(height >= 0);
   new_stack->set_top(new_stack->length() - height);
@@ -207,7 +241,6 @@ Process::StackCheckResult Process::HandleStackOverflow(int addition) {
   coroutine_->set_stack(new_stack);
   GCMetadata::InsertIntoRememberedSet(coroutine_->stack()->address());
   UpdateStackLimit();
-  return kStackCheckContinue;
 }
 
 Object* Process::NewByteArray(int length) {
@@ -342,6 +375,21 @@ Object* Process::NewStack(int length) {
   return result;
 }
 
+Object* Process::NewCoroutineStack() {
+  if (stack_pool_size_ == 0) return NewStack(kInitialStackSize);
+  Stack* stack = stack_pool_[--stack_pool_size_];
+  // The stack is about to be filled with new pointers and may live in
+  // old-space.
+  GCMetadata::InsertIntoRememberedSet(stack->address());
+  return stack;
+}
+
+void Process::RecycleStack(Stack* stack) {
+  if (stack_pool_size_ == kStackPoolSize) return;
+  if (stack->length() > kMaxPooledStackSize) return;
+  stack_pool_[stack_pool_size_++] = stack;
+}
+
 void Process::IterateRoots(PointerVisitor* visitor) {
   visitor->Visit(reinterpret_cast<Object**>(&statics_));
   visitor->Visit(reinterpret_cast<Object**>(&coroutine_));
@@ -356,6 +404,9 @@ void Process::IterateProgramPointers(PointerVisitor* visitor) {
   // TODO(erikcorry): Somehow assert that the stacks are cooked (there's no
   // simple way to tell in a multiple-processes-per-heap world).
   if (debug_info_ != NULL) debug_info_->VisitProgramPointers(visitor);
+  if (function_counters_ != NULL) {
+    function_counters_->VisitProgramPointers(visitor);
+  }
   visitor->Visit(&exception_);
   mailbox_.IteratePointers(visitor);
 }
@@ -467,6 +518,9 @@ void Process::UpdateBreakpoints() {
   if (debug_info_ != NULL) {
     debug_info_->UpdateBreakpoints();
   }
+  if (function_counters_ != NULL) {
+    function_counters_->UpdateFunctions();
+  }
 }
 
 void Process::RegisterFinalizer(HeapObject* object,
@@ -641,6 +695,7 @@ BEGIN_NATIVE(ProcessQueueGetMessage) {
   switch (kind) {
     case Message::IMMEDIATE:
     case Message::IMMUTABLE_OBJECT:
+    case Message::COPIED_OBJECT:
       result = reinterpret_cast<Object*>(queue->value());
       break;
 
@@ -654,6 +709,10 @@ BEGIN_NATIVE(ProcessQueueGetMessage) {
       foreign->SetConsecutiveSmis(0, queue->value());
       int size = queue->size();
       foreign->SetInstanceField(2, Smi::FromWord(size));
+      Program* program = process->program();
+      foreign->SetInstanceField(3, kind == Message::FOREIGN_FINALIZED
+                                       ? program->true_object()
+                                       : program->false_object());
       if (kind == Message::FOREIGN_FINALIZED) {
         process->RegisterFinalizer(foreign, Process::FinalizeForeign,
                                    process->heap());
@@ -696,11 +755,44 @@ BEGIN_NATIVE(ProcessQueueGetMessage) {
       UNREACHABLE();
   }
 
-  mailbox->AdvanceCurrentMessage();
+  mailbox->AdvanceCurrentMessage(process->message_cache());
   return result;
 }
 END_NATIVE()
 
+BEGIN_NATIVE(ProcessQueueGetMessages) {
+  Object* list = Instance::cast(arguments[0])->GetInstanceField(0);
+  Array* batch = Array::cast(list);
+  MessageMailbox* mailbox = process->mailbox();
+  MessageCache* cache = process->message_cache();
+
+  // Fill [batch] with channel and message pairs without allocating. Stop at
+  // the first message that needs an allocation to be received; those are
+  // handled one at a time by ProcessQueueGetMessage.
+  int index = 0;
+  while (index + 1 < batch->length()) {
+    Message* queue = mailbox->CurrentMessage();
+    if (queue == NULL) break;
+    Message::Kind kind = queue->kind();
+    if (kind != Message::IMMEDIATE && kind != Message::IMMUTABLE_OBJECT &&
+        kind != Message::COPIED_OBJECT) {
+      break;
+    }
+    Instance* channel = queue->port()->channel();
+    if (channel != NULL && !queue->port()->IsOverflowing()) {
+      Object* message = reinterpret_cast<Object*>(queue->value());
+      batch->set(index, channel);
+      process->RecordStore(batch, channel);
+      batch->set(index + 1, message);
+      process->RecordStore(batch, message);
+      index += 2;
+    }
+    mailbox->AdvanceCurrentMessage(cache);
+  }
+  return Smi::FromWord(index);
+}
+END_NATIVE()
+
 BEGIN_NATIVE(ProcessQueueSetupProcessDeath) {
   MessageMailbox* mailbox = process->mailbox();
   Message* queue = mailbox->CurrentMessage();
@@ -723,7 +815,7 @@ BEGIN_NATIVE(ProcessQueueSetupProcessDeath) {
   process->RegisterFinalizer(HeapObject::cast(dart_process),
                              Process::FinalizeProcess);
 
-  mailbox->AdvanceCurrentMessage();
+  mailbox->AdvanceCurrentMessage(process->message_cache());
   return arguments[0];
 }
 END_NATIVE()
@@ -734,11 +826,16 @@ BEGIN_NATIVE(ProcessQueueGetChannel) {
   Message* queue = mailbox->CurrentMessage();
   // The channel for a port can die independently of the port. In that case
   // messages sent to the port can never be received. In that case we drop the
-  // message when processing the message queue.
+  // message when processing the message queue. Messages are also dropped
+  // from the front of a drop-oldest port that has overflowed.
   while (queue != NULL) {
     Instance* channel = queue->port()->channel();
-    if (channel != NULL) return channel;
-    mailbox->AdvanceCurrentMessage();
+    if (channel != NULL && !queue->port()->IsOverflowing()) return channel;
+    if (queue->kind() == Message::FOREIGN_FINALIZED) {
+      // The memory was transferred to this process, so free it here.
+      free(reinterpret_cast<void*>(queue->value()));
+    }
+    mailbox->AdvanceCurrentMessage(process->message_cache());
     queue = mailbox->CurrentMessage();
   }
   return process->program()->null_object();
@@ -8,6 +8,8 @@
 #include "src/shared/atomic.h"
 #include "src/shared/random.h"
 
+#include "src/vm/bytecode_profiler.h"
+#include "src/vm/catch_block_cache.h"
 #include "src/vm/debug_info.h"
 #include "src/vm/gc_metadata.h"
 #include "src/vm/heap.h"
@@ -108,6 +110,10 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
   void SetupExecutionStack();
   StackCheckResult HandleStackOverflow(int addition);
 
+  // Replace the stack of a sleeping process by a smaller one if it only
+  // uses a small part of it. Called after garbage collection.
+  void ShrinkStack();
+
   inline LookupCache::Entry* LookupEntry(Object* receiver, int selector);
 
   // Lookup and update the primary cache entry.
@@ -168,6 +174,13 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
   Object* NewBoxed(Object* value);
   Object* NewStack(int length);
 
+  // Coroutine stacks are recycled through a small per-process pool, so
+  // creating many short-lived coroutines does not churn new space. The pool
+  // only holds stacks between garbage collections.
+  Object* NewCoroutineStack();
+  void RecycleStack(Stack* stack);
+  void ClearStackPool() { stack_pool_size_ = 0; }
+
   Object* NewInstance(Class* klass, bool immutable = false);
 
   // Returns either a Smi or a LargeInteger.
@@ -204,6 +217,25 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
   // Bytecode pointers need to be updated.
   void UpdateBreakpoints();
 
+  CatchBlockCache* catch_block_cache() {
+    if (catch_block_cache_ == NULL) catch_block_cache_ = new CatchBlockCache();
+    return catch_block_cache_;
+  }
+  void ClearCatchBlockCache() {
+    if (catch_block_cache_ != NULL) catch_block_cache_->Clear();
+  }
+
+  // Bytecode profiling support. The bytecode counters belong to the worker
+  // thread currently interpreting this process.
+  BytecodeCounters* bytecode_counters() const { return bytecode_counters_; }
+  void set_bytecode_counters(BytecodeCounters* counters) {
+    bytecode_counters_ = counters;
+  }
+  FunctionCounters* function_counters() const { return function_counters_; }
+  void set_function_counters(FunctionCounters* counters) {
+    function_counters_ = counters;
+  }
+
   // Change the state from 'from' to 'to. Return 'true' if the operation was
   // successful.
   inline bool ChangeState(State from, State to);
@@ -245,6 +277,7 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
   RandomXorShift* random() { return &random_; }
 
   MessageMailbox* mailbox() { return &mailbox_; }
+  MessageCache* message_cache() { return &message_cache_; }
 
   Signal* signal() { return signal_.load(); }
 
@@ -298,6 +331,9 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
 
   void UpdateStackLimit();
 
+  // Move the frames of the current stack to [new_stack] and install it.
+  void ReplaceStack(Stack* new_stack);
+
   // Put these first so they can be accessed from the interpreter without
   // issues around object layout.
   void* native_stack_;
@@ -326,6 +362,7 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
 
   Atomic<Signal*> signal_;
   MessageMailbox mailbox_;
+  MessageCache message_cache_;
 
   ProcessHandle* process_handle_;
 
@@ -342,6 +379,19 @@ class Process : public ProcessList::Entry, public ProcessQueueList::Entry {
 
   ProcessDebugInfo* debug_info_;
 
+  BytecodeCounters* bytecode_counters_;
+  FunctionCounters* function_counters_;
+
+  // Allocated on the first throw.
+  CatchBlockCache* catch_block_cache_;
+
+  // Recycled coroutine stacks, see [NewCoroutineStack]. Stacks longer than
+  // kMaxPooledStackSize words are left to the GC.
+  static const int kStackPoolSize = 16;
+  static const int kMaxPooledStackSize = 4 * kInitialStackSize;
+  Stack* stack_pool_[kStackPoolSize];
+  int stack_pool_size_;
+
   List<List<uint8>> arguments_;
 
   // The scheduler that is currently executing an interpreter in this process.
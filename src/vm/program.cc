@@ -176,6 +176,7 @@ bool Program::ScheduleProcessForDeletion(Process* process, Signal::Kind kind) {
       exit_kind_ = current->links()->exit_signal();
     }
 
+    BytecodeProfiler::RecordProcess(this, current);
     RemoveFromProcessList(current);
     delete current;
 
@@ -347,6 +348,7 @@ class FinishProgramGCVisitor : public ProcessVisitor {
  public:
   virtual void VisitProcess(Process* process) {
     process->UpdateBreakpoints();
+    process->ClearCatchBlockCache();
   }
 };
 
@@ -614,6 +616,7 @@ void Program::PerformSharedGarbageCollection() {
   // detect liveness paths that go through new-space, but we just clear the
   // mark bits afterwards.  Dead objects in new-space are only cleared in a
   // new-space GC (scavenge).
+  ClearStackPools();
   TwoSpaceHeap* heap = process_heap();
   OldSpace* old_space = heap->old_space();
   SemiSpace* new_space = heap->space();
@@ -1189,6 +1192,8 @@ void PrintProcessGCInfo(HeapUsage* before, HeapUsage* after) {
 void Program::CollectNewSpace() {
   HeapUsage usage_before;
 
+  ClearStackPools();
+
   TwoSpaceHeap* data_heap = process_heap();
 
   SemiSpace* from = data_heap->space();
@@ -1281,6 +1286,17 @@ void Program::UpdateStackLimits() {
   for (auto process : process_list_) process->UpdateStackLimit();
 }
 
+void Program::ClearStackPools() {
+  // Pooled stacks are not roots, so they must be dropped before their
+  // memory is reclaimed.
+  for (auto process : process_list_) process->ClearStackPool();
+}
+
+void Program::ShrinkSleepingStacks() {
+  // The stacks replaced here are garbage and are reclaimed by the next GC.
+  for (auto process : process_list_) process->ShrinkStack();
+}
+
 void Program::IterateSharedHeapRoots(PointerVisitor* visitor) {
   // All processes share the same heap, so we need to iterate all roots from
   // all processes.
@@ -1289,6 +1305,8 @@ void Program::IterateSharedHeapRoots(PointerVisitor* visitor) {
 }
 
 int Program::CollectMutableGarbageAndChainStacks() {
+  ClearStackPools();
+
   // Mark all reachable objects.
   OldSpace* old_space = process_heap()->old_space();
   SemiSpace* new_space = process_heap()->space();
@@ -292,6 +292,8 @@ class Program : public ProgramList::Entry {
   void CollectOldSpace();
   void CollectOldSpaceIfNeeded(bool force);
   void CollectNewSpace();
+  // Give back unused stack space of processes that are not running.
+  void ShrinkSleepingStacks();
   void PerformSharedGarbageCollection();
 
   void PrintStatistics();
@@ -367,6 +369,7 @@ class Program : public ProgramList::Entry {
   void UncookAndUnchainStacks();
   bool stacks_are_cooked() { return !cooked_stack_deltas_.is_empty(); }
   void UpdateStackLimits();
+  void ClearStackPools();
   void CompactSharedHeap();
   void SweepSharedHeap();
   void IterateSharedHeapRoots(PointerVisitor* visitor);
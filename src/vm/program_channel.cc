@@ -0,0 +1,270 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/program_channel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/shared/platform.h"
+#include "src/shared/utils.h"
+
+#include "src/vm/event_handler.h"
+#include "src/vm/natives.h"
+#include "src/vm/object.h"
+#include "src/vm/port.h"
+#include "src/vm/process.h"
+
+namespace dartino {
+
+static Mutex* registry_mutex = NULL;
+static ProgramChannel* channels = NULL;
+
+void ProgramChannel::Setup() {
+  ASSERT(registry_mutex == NULL);
+  registry_mutex = Platform::CreateMutex();
+}
+
+void ProgramChannel::TearDown() {
+  while (channels != NULL) {
+    ProgramChannel* next = channels->next_;
+    delete channels;
+    channels = next;
+  }
+  delete registry_mutex;
+  registry_mutex = NULL;
+}
+
+ProgramChannel::ProgramChannel(char* name, int capacity)
+    : name_(name),
+      capacity_(capacity),
+      buffer_(static_cast<uint8*>(malloc(capacity))),
+      ref_count_(1),
+      next_(NULL),
+      head_(0),
+      tail_(0),
+      pending_tail_(0),
+      receiver_(NULL) {
+  ASSERT(Utils::IsPowerOfTwo(capacity));
+}
+
+ProgramChannel::~ProgramChannel() {
+  Port* receiver = receiver_.exchange(NULL);
+  if (receiver != NULL) receiver->DecrementRef();
+  free(buffer_);
+  free(name_);
+}
+
+ProgramChannel* ProgramChannel::Open(const char* name, int capacity) {
+  ScopedLock lock(registry_mutex);
+  for (ProgramChannel* channel = channels; channel != NULL;
+       channel = channel->next_) {
+    if (strcmp(channel->name_, name) == 0) {
+      channel->ref_count_++;
+      return channel;
+    }
+  }
+  int size = kMinCapacity;
+  while (size < capacity) size <<= 1;
+  ProgramChannel* channel = new ProgramChannel(strdup(name), size);
+  channel->next_ = channels;
+  channels = channel;
+  return channel;
+}
+
+void ProgramChannel::IncrementRef() {
+  ScopedLock lock(registry_mutex);
+  ASSERT(ref_count_ > 0);
+  ref_count_++;
+}
+
+void ProgramChannel::DecrementRef() {
+  ScopedLock lock(registry_mutex);
+  ASSERT(ref_count_ > 0);
+  if (--ref_count_ > 0) return;
+  ProgramChannel** link = &channels;
+  while (*link != this) link = &(*link)->next_;
+  *link = next_;
+  delete this;
+}
+
+uint8* ProgramChannel::BeginWrite(int length) {
+  ASSERT(CanHold(length));
+  write_lock_.Lock();
+  uword tail = tail_.load(kRelaxed);
+  uword free_space = capacity_ - (tail - head_.load(kAcquire));
+  uword record = RecordSize(length);
+  // Records are never split. If the record does not fit before the end of
+  // the buffer, the rest of the buffer is skipped.
+  uword until_end = capacity_ - (tail & (capacity_ - 1));
+  uword needed = (record <= until_end) ? record : until_end + record;
+  if (needed > free_space) {
+    write_lock_.Unlock();
+    return NULL;
+  }
+  if (record > until_end) {
+    *HeaderAt(tail) = kPaddingMarker;
+    tail += until_end;
+  }
+  *HeaderAt(tail) = length;
+  pending_tail_ = tail + record;
+  return reinterpret_cast<uint8*>(HeaderAt(tail) + 1);
+}
+
+void ProgramChannel::EndWrite() {
+  tail_.store(pending_tail_, kRelease);
+  write_lock_.Unlock();
+  if (receiver_.load(kAcquire) != NULL) {
+    Port* receiver = receiver_.exchange(NULL);
+    if (receiver != NULL) EventHandler::Send(receiver, 0, true);
+  }
+}
+
+uint8* ProgramChannel::Peek(int* length) {
+  uword head = head_.load(kRelaxed);
+  if (head == tail_.load(kAcquire)) return NULL;
+  uint32 header = *HeaderAt(head);
+  if (header == kPaddingMarker) {
+    // The writer publishes the padding together with the record after it.
+    head += capacity_ - (head & (capacity_ - 1));
+    head_.store(head, kRelease);
+    header = *HeaderAt(head);
+  }
+  *length = header;
+  return reinterpret_cast<uint8*>(HeaderAt(head) + 1);
+}
+
+void ProgramChannel::Consume() {
+  uword head = head_.load(kRelaxed);
+  ASSERT(head != tail_.load(kAcquire));
+  ASSERT(*HeaderAt(head) != kPaddingMarker);
+  head_.store(head + RecordSize(*HeaderAt(head)), kRelease);
+}
+
+ProgramChannel::WaitResult ProgramChannel::WaitForMessage(Port* port) {
+  port->IncrementRef();
+  Port* previous = NULL;
+  if (!receiver_.compare_exchange_strong(previous, port)) {
+    // The waiting receiver's port is taken by the next writer, so a second
+    // receiver cannot replace it without losing that wakeup.
+    port->DecrementRef();
+    return kBusy;
+  }
+  if (IsEmpty()) return kWaiting;
+  // A message arrived in the meantime. If a writer already took the port, a
+  // wakeup is on its way.
+  Port* receiver = receiver_.exchange(NULL);
+  if (receiver == NULL) return kWaiting;
+  receiver->DecrementRef();
+  return kAvailable;
+}
+
+static ProgramChannel* FromDartObject(Object* object) {
+  Object* handle = Instance::cast(object)->GetInstanceField(0);
+  if (!handle->IsSmi() || Smi::cast(handle)->value() == 0) return NULL;
+  return reinterpret_cast<ProgramChannel*>(Smi::cast(handle)->value() << 2);
+}
+
+void ProgramChannel::WeakCallback(HeapObject* object, void*) {
+  ProgramChannel* channel = FromDartObject(object);
+  if (channel != NULL) channel->DecrementRef();
+}
+
+BEGIN_NATIVE(ProgramChannelOpen) {
+  Instance* instance = Instance::cast(arguments[0]);
+  if (!arguments[2]->IsSmi()) return Failure::wrong_argument_type();
+  word capacity = Smi::cast(arguments[2])->value();
+  if (capacity < 0 || capacity > (1 << 30)) {
+    return Failure::index_out_of_bounds();
+  }
+  char* name = AsForeignString(arguments[1]);
+  if (name == NULL) return Failure::wrong_argument_type();
+  ProgramChannel* channel = ProgramChannel::Open(name, capacity);
+  free(name);
+
+  ASSERT((reinterpret_cast<uword>(channel) & 3) == 0);  // Always aligned.
+  Smi* handle = Smi::FromWord(reinterpret_cast<uword>(channel) >> 2);
+  instance->SetInstanceField(0, handle);
+  process->RegisterFinalizer(instance, ProgramChannel::WeakCallback);
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(ProgramChannelClose) {
+  Instance* instance = Instance::cast(arguments[0]);
+  ProgramChannel* channel = FromDartObject(instance);
+  if (channel == NULL) return Failure::illegal_state();
+  instance->SetInstanceField(0, Smi::FromWord(0));
+  channel->DecrementRef();
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(ProgramChannelSend) {
+  ProgramChannel* channel = FromDartObject(arguments[0]);
+  if (channel == NULL) return Failure::illegal_state();
+  if (!arguments[1]->IsSmi() && !arguments[1]->IsLargeInteger()) {
+    return Failure::wrong_argument_type();
+  }
+  if (!arguments[2]->IsSmi()) return Failure::wrong_argument_type();
+  uint8* bytes = reinterpret_cast<uint8*>(AsForeignWord(arguments[1]));
+  word length = Smi::cast(arguments[2])->value();
+  if (!channel->CanHold(length)) return Failure::index_out_of_bounds();
+
+  uint8* payload = channel->BeginWrite(length);
+  if (payload == NULL) return process->program()->false_object();
+  if (length > 0) memcpy(payload, bytes, length);
+  channel->EndWrite();
+  return process->program()->true_object();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(ProgramChannelNextSize) {
+  ProgramChannel* channel = FromDartObject(arguments[0]);
+  if (channel == NULL) return Failure::illegal_state();
+  int length;
+  if (channel->Peek(&length) == NULL) return Smi::FromWord(-1);
+  return Smi::FromWord(length);
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(ProgramChannelReceive) {
+  ProgramChannel* channel = FromDartObject(arguments[0]);
+  if (channel == NULL) return Failure::illegal_state();
+  if (!arguments[1]->IsSmi() && !arguments[1]->IsLargeInteger()) {
+    return Failure::wrong_argument_type();
+  }
+  if (!arguments[2]->IsSmi()) return Failure::wrong_argument_type();
+  uint8* bytes = reinterpret_cast<uint8*>(AsForeignWord(arguments[1]));
+  int length;
+  uint8* payload = channel->Peek(&length);
+  if (payload == NULL || length != Smi::cast(arguments[2])->value()) {
+    return Failure::illegal_state();
+  }
+  if (length > 0) memcpy(bytes, payload, length);
+  channel->Consume();
+  return process->program()->null_object();
+}
+END_NATIVE()
+
+BEGIN_LEAF_NATIVE(ProgramChannelWait) {
+  ProgramChannel* channel = FromDartObject(arguments[0]);
+  if (channel == NULL) return Failure::illegal_state();
+  if (!arguments[1]->IsPort()) return Failure::wrong_argument_type();
+  Port* port = Port::FromDartObject(arguments[1]);
+  if (port == NULL) return Failure::illegal_state();
+  switch (channel->WaitForMessage(port)) {
+    case ProgramChannel::kWaiting:
+      return process->program()->true_object();
+    case ProgramChannel::kAvailable:
+      return process->program()->false_object();
+    case ProgramChannel::kBusy:
+      return Failure::index_out_of_bounds();
+  }
+  UNREACHABLE();
+  return NULL;
+}
+END_NATIVE()
+
+}  // namespace dartino
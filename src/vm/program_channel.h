@@ -0,0 +1,108 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_PROGRAM_CHANNEL_H_
+#define SRC_VM_PROGRAM_CHANNEL_H_
+
+#include "src/shared/atomic.h"
+#include "src/shared/globals.h"
+
+#include "src/vm/spinlock.h"
+
+namespace dartino {
+
+class HeapObject;
+class Object;
+class Port;
+
+// A named byte channel between programs running in the same VM. Programs
+// have separate heaps, so payloads are copied into a ring buffer outside of
+// any heap and copied out again by the receiver.
+//
+// Any number of processes can send to a channel, but only one process may
+// receive from it at a time. Writers are serialized by a spinlock, while the
+// reader only synchronizes with them through the atomic head and tail
+// positions. A receiver waiting for data is woken up through its port.
+class ProgramChannel {
+ public:
+  static const int kMinCapacity = 256;
+
+  // Initializes the channel registry, called once.
+  static void Setup();
+  // Deletes the remaining channels and reverses the Setup call.
+  static void TearDown();
+
+  // Returns the channel called [name], creating it with room for [capacity]
+  // bytes if it does not exist. The caller owns a reference to the channel.
+  static ProgramChannel* Open(const char* name, int capacity);
+
+  void IncrementRef();
+  // Drops a reference. The channel is deleted with its last reference.
+  void DecrementRef();
+
+  // Tells whether a [length] byte message can ever fit in the channel.
+  bool CanHold(int length) const {
+    return length >= 0 && RecordSize(length) <= capacity_ / 2;
+  }
+
+  // Reserves room for a [length] byte message and returns the address to
+  // copy it to, or NULL if the channel is full. Every successful call must
+  // be followed by EndWrite.
+  uint8* BeginWrite(int length);
+  // Publishes the message and wakes up a waiting receiver.
+  void EndWrite();
+
+  // Returns the next message and its length, or NULL if the channel is
+  // empty. The message stays in the channel until Consume is called.
+  uint8* Peek(int* length);
+  void Consume();
+
+  enum WaitResult { kWaiting, kAvailable, kBusy };
+
+  // Registers [port] to be notified about the next message. Returns
+  // kAvailable without registering if a message is already available, and
+  // kBusy if another receiver is waiting.
+  WaitResult WaitForMessage(Port* port);
+
+  static void WeakCallback(HeapObject* object, void*);
+
+ private:
+  static const uint32 kPaddingMarker = 0xffffffff;
+  static const int kHeaderSize = sizeof(uint32);
+
+  ProgramChannel(char* name, int capacity);
+  ~ProgramChannel();
+
+  static uword RecordSize(int length) {
+    return (kHeaderSize + length + kHeaderSize - 1) & ~(kHeaderSize - 1);
+  }
+
+  uint32* HeaderAt(uword position) {
+    return reinterpret_cast<uint32*>(buffer_ + (position & (capacity_ - 1)));
+  }
+
+  bool IsEmpty() const { return head_.load(kAcquire) == tail_.load(kAcquire); }
+
+  char* const name_;
+  const uword capacity_;
+  uint8* const buffer_;
+
+  // Owned by the registry lock.
+  int ref_count_;
+  ProgramChannel* next_;
+
+  // Byte positions of the reader and writers. They only ever increase, the
+  // buffer index is the position modulo the capacity.
+  Atomic<uword> head_;
+  Atomic<uword> tail_;
+
+  Spinlock write_lock_;
+  uword pending_tail_;
+
+  Atomic<Port*> receiver_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_PROGRAM_CHANNEL_H_
@@ -112,6 +112,14 @@ class ProgramRewriter {
 // To optimize, we post process all functions in the heap to
 // adjust the bytecodes to take advantage of selector offsets
 // and class ids.
+//
+// The rewriting is done in place and never changes the size of a
+// bytecode: bytecode pointers are stored in frames, catch tables,
+// breakpoints and tick samples, and they must remain valid across
+// folding and unfolding. Translating functions into a different
+// representation, such as word-aligned threaded code, would need a
+// side table mapping code back to bytecode pointers. It would also need
+// a matching dispatch mode in every interpreter generator.
 class FunctionOptimizingVisitor : public HeapObjectVisitor {
  public:
   explicit FunctionOptimizingVisitor(ProgramRewriter* rewriter)
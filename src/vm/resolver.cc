@@ -0,0 +1,227 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/resolver.h"
+
+#if defined(DARTINO_TARGET_OS_POSIX)
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/shared/flags.h"
+#include "src/vm/blocking_call_pool.h"
+#include "src/vm/event_handler.h"
+#include "src/vm/port.h"
+
+namespace dartino {
+
+struct Resolver::Waiter {
+  Port* port;
+  Waiter* next;
+};
+
+struct Resolver::Entry {
+  char* host;
+  uword hash;
+  int64 result;
+  // The time in microseconds the result expires.
+  int64 expires;
+  bool pending;
+  Waiter* waiters;
+  Entry* next;
+};
+
+class Resolver::ResolveTask : public BlockingTask {
+ public:
+  ResolveTask(Resolver* resolver, const char* host)
+      : resolver_(resolver), host_(strdup(host)), done_(false) {}
+
+  // A task dropped without running fails its lookup, so the waiters are
+  // released.
+  ~ResolveTask() {
+    if (!done_) resolver_->Complete(host_, -1);
+    free(host_);
+  }
+
+  void Perform() {
+    resolver_->Complete(host_, Resolve(host_));
+    done_ = true;
+  }
+
+ private:
+  Resolver* const resolver_;
+  char* const host_;
+  bool done_;
+};
+
+static uword HashHost(const char* host) {
+  // FNV-1a. Utils::StringHash wants aligned data.
+  uint32 hash = 2166136261u;
+  for (const char* p = host; *p != '\0'; p++) {
+    hash = (hash ^ static_cast<uint8>(*p)) * 16777619u;
+  }
+  return hash;
+}
+
+Resolver* Resolver::instance_ = NULL;
+
+void Resolver::Setup() {
+  ASSERT(instance_ == NULL);
+  instance_ = new Resolver();
+}
+
+void Resolver::TearDown() {
+  ASSERT(instance_ != NULL);
+  Resolver* resolver = instance_;
+  instance_ = NULL;
+  bool pending;
+  {
+    ScopedLock locker(resolver->mutex_);
+    pending = resolver->pending_ > 0;
+  }
+  // A lookup that is still running completes into the resolver, so it is
+  // leaked like the thread running it.
+  if (pending) return;
+  delete resolver;
+}
+
+Resolver::Resolver()
+    : mutex_(Platform::CreateMutex()), count_(0), pending_(0) {
+  for (int i = 0; i < kBuckets; i++) buckets_[i] = NULL;
+}
+
+Resolver::~Resolver() {
+  Clear();
+  ASSERT(count_ == 0);
+  delete mutex_;
+}
+
+bool Resolver::Lookup(const char* host, Port* port, int64* result) {
+  ScopedLock locker(mutex_);
+  uword hash = HashHost(host);
+  Entry* entry = Find(host, hash);
+  if (entry != NULL && !entry->pending &&
+      entry->expires > static_cast<int64>(Platform::GetMicroseconds())) {
+    *result = entry->result;
+    return true;
+  }
+  if (port == NULL) return false;
+  if (entry == NULL) {
+    if (count_ >= kMaxEntries) EvictOne();
+    entry = new Entry();
+    entry->host = strdup(host);
+    entry->hash = hash;
+    entry->pending = false;
+    entry->waiters = NULL;
+    Entry** bucket = &buckets_[hash & (kBuckets - 1)];
+    entry->next = *bucket;
+    *bucket = entry;
+    count_++;
+  }
+  port->IncrementRef();
+  Waiter* waiter = new Waiter();
+  waiter->port = port;
+  waiter->next = entry->waiters;
+  entry->waiters = waiter;
+  if (!entry->pending) {
+    entry->pending = true;
+    pending_++;
+    BlockingCallPool::GlobalInstance()->Submit(new ResolveTask(this, host));
+  }
+  return false;
+}
+
+void Resolver::Clear() {
+  ScopedLock locker(mutex_);
+  for (int i = 0; i < kBuckets; i++) {
+    Entry* entry = buckets_[i];
+    while (entry != NULL) {
+      Entry* next = entry->next;
+      if (!entry->pending) Remove(entry);
+      entry = next;
+    }
+  }
+}
+
+int64 Resolver::Resolve(const char* host) {
+#if defined(DARTINO_TARGET_OS_POSIX)
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  struct addrinfo* info = NULL;
+  int status = getaddrinfo(host, NULL, &hints, &info);
+  if (status != 0) return status < 0 ? status : -status;
+  int64 result = EAI_NONAME < 0 ? EAI_NONAME : -EAI_NONAME;
+  for (struct addrinfo* i = info; i != NULL; i = i->ai_next) {
+    if (i->ai_family != AF_INET) continue;
+    struct sockaddr_in* address =
+        reinterpret_cast<struct sockaddr_in*>(i->ai_addr);
+    result = ntohl(address->sin_addr.s_addr);
+    break;
+  }
+  freeaddrinfo(info);
+  return result;
+#else
+  return -1;
+#endif
+}
+
+void Resolver::Complete(const char* host, int64 result) {
+  Waiter* waiters;
+  {
+    ScopedLock locker(mutex_);
+    Entry* entry = Find(host, HashHost(host));
+    ASSERT(entry != NULL && entry->pending);
+    int ttl = result >= 0 ? Flags::resolver_ttl : Flags::resolver_negative_ttl;
+    entry->result = result;
+    entry->expires = Platform::GetMicroseconds() + ttl * 1000000LL;
+    entry->pending = false;
+    waiters = entry->waiters;
+    entry->waiters = NULL;
+    pending_--;
+  }
+  while (waiters != NULL) {
+    Waiter* next = waiters->next;
+    EventHandler::Send(waiters->port, result, true);
+    delete waiters;
+    waiters = next;
+  }
+}
+
+Resolver::Entry* Resolver::Find(const char* host, uword hash) {
+  for (Entry* entry = buckets_[hash & (kBuckets - 1)]; entry != NULL;
+       entry = entry->next) {
+    if (entry->hash == hash && strcmp(entry->host, host) == 0) return entry;
+  }
+  return NULL;
+}
+
+void Resolver::Remove(Entry* entry) {
+  ASSERT(!entry->pending && entry->waiters == NULL);
+  Entry** link = &buckets_[entry->hash & (kBuckets - 1)];
+  while (*link != entry) link = &(*link)->next;
+  *link = entry->next;
+  free(entry->host);
+  delete entry;
+  count_--;
+}
+
+void Resolver::EvictOne() {
+  // The cache is small, so finding the entry closest to expiring by going
+  // through all of them is fine.
+  Entry* oldest = NULL;
+  for (int i = 0; i < kBuckets; i++) {
+    for (Entry* entry = buckets_[i]; entry != NULL; entry = entry->next) {
+      if (entry->pending) continue;
+      if (oldest == NULL || entry->expires < oldest->expires) oldest = entry;
+    }
+  }
+  if (oldest != NULL) Remove(oldest);
+}
+
+}  // namespace dartino
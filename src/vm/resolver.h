@@ -0,0 +1,69 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_RESOLVER_H_
+#define SRC_VM_RESOLVER_H_
+
+#include "src/shared/globals.h"
+#include "src/shared/platform.h"
+
+namespace dartino {
+
+class Port;
+
+// Resolves host names to IPv4 addresses on the BlockingCallPool and caches
+// the results for the whole VM. Failed lookups are cached too, for a
+// shorter time.
+//
+// A result is the address in host byte order, or a negative error code if
+// the host could not be resolved.
+class Resolver {
+ public:
+  static void Setup();
+  static void TearDown();
+
+  static Resolver* GlobalInstance() { return instance_; }
+
+  // Returns true and stores the cached result for [host] in [result] if it
+  // has not expired. Otherwise, unless [port] is NULL, the host is resolved
+  // and the result is sent to [port]. Lookups of a host that is already
+  // being resolved wait for the same result.
+  bool Lookup(const char* host, Port* port, int64* result);
+
+  // Drops all cached results that are not being resolved.
+  void Clear();
+
+ private:
+  struct Waiter;
+  struct Entry;
+  class ResolveTask;
+
+  static const int kBuckets = 64;
+  static const int kMaxEntries = 256;
+
+  Resolver();
+  ~Resolver();
+
+  // Resolves [host] on the calling thread.
+  static int64 Resolve(const char* host);
+
+  // Stores the [result] of resolving [host] and sends it to the waiters.
+  void Complete(const char* host, int64 result);
+
+  Entry* Find(const char* host, uword hash);
+  void Remove(Entry* entry);
+  void EvictOne();
+
+  static Resolver* instance_;
+
+  Mutex* mutex_;
+  Entry* buckets_[kBuckets];
+  int count_;
+  // The number of hosts being resolved.
+  int pending_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_RESOLVER_H_
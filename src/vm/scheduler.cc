@@ -5,6 +5,7 @@
 #include "src/vm/scheduler.h"
 
 #include "src/shared/flags.h"
+#include "src/shared/utils.h"
 
 #include "src/vm/frame.h"
 #include "src/vm/interpreter.h"
@@ -21,9 +22,13 @@ namespace dartino {
 Scheduler* Scheduler::scheduler_ = NULL;
 
 WorkerThread::WorkerThread(Scheduler* scheduler)
-    : scheduler_(scheduler) {}
+    : scheduler_(scheduler),
+      bytecode_counters_(BytecodeProfiler::NewThreadCounters()),
+      parked_(NULL),
+      handoffs_(0),
+      spin_budget_(Flags::idle_spin_count) {}
 
-WorkerThread::~WorkerThread() { }
+WorkerThread::~WorkerThread() { ASSERT(parked_ == NULL); }
 
 void InterpretationBarrier::PreemptProcess() {
   Process* process = current_process;
@@ -91,6 +96,7 @@ Scheduler::Scheduler()
       pause_(false),
       shutdown_(false),
       idle_monitor_(Platform::CreateMonitor()),
+      idle_waiters_(0),
       interpreter_semaphore_(1) {
   for (int i = 0; i < kThreadCount; i++) {
     WorkerThread* worker = new WorkerThread(this);
@@ -318,6 +324,26 @@ void Scheduler::RescheduleProcess(Process* process, bool terminate) {
   }
 }
 
+void Scheduler::ParkProcess(Process* process, bool terminate,
+                            WorkerThread* worker) {
+  if (terminate || worker->parked_ != NULL ||
+      worker->handoffs_ >= Flags::handoff_limit) {
+    RescheduleProcess(process, terminate);
+    return;
+  }
+  ASSERT(process->state() == Process::kRunning);
+  worker->handoffs_++;
+  worker->parked_ = process;
+}
+
+void Scheduler::UnparkProcess(WorkerThread* worker) {
+  Process* process = worker->parked_;
+  if (process == NULL) return;
+  worker->parked_ = NULL;
+  process->ChangeState(Process::kRunning, Process::kEnqueuing);
+  EnqueueProcess(process);
+}
+
 void WorkerThread::RunInThread() {
   ThreadEnter();
   bool running = true;
@@ -336,14 +362,22 @@ bool Scheduler::RunInterpreterLoop(WorkerThread* worker) {
     while (!pause_ && !shutdown_) {
       Process* process = NULL;
       if (!DequeueProcess(&process)) break;
+      worker->handoffs_ = 0;
 
       while (process != NULL && !shutdown_ && !pause_) {
         process = InterpretProcess(process, worker);
+        if (process == NULL) {
+          // Resume the process that handed over the thread, while its data
+          // is still in the caches.
+          process = worker->parked_;
+          worker->parked_ = NULL;
+        }
       }
       if (process != NULL) {
         process->ChangeState(Process::kRunning, Process::kEnqueuing);
         EnqueueProcess(process);
       }
+      UnparkProcess(worker);
     }
 
     if (shutdown_) break;
@@ -357,7 +391,9 @@ bool Scheduler::RunInterpreterLoop(WorkerThread* worker) {
       }
       {
         ScopedMonitorLock idle_locker(idle_monitor_);
+        idle_waiters_++;
         while (pause_) idle_monitor_->Wait();
+        idle_waiters_--;
       }
       {
         ScopedMonitorLock locker(pause_monitor_);
@@ -367,17 +403,43 @@ bool Scheduler::RunInterpreterLoop(WorkerThread* worker) {
       continue;
     }
 
+    // Spin for a while before going to sleep, as new work often arrives
+    // right away and waking up a sleeping thread is expensive.
+    if (SpinForWork(worker)) continue;
+
     // Sleep until there is something new to execute.
     ScopedMonitorLock scoped_lock(idle_monitor_);
+    idle_waiters_++;
     while (ready_queue_.IsEmpty() && !pause_ && !shutdown_) {
       idle_monitor_->Wait();
     }
+    idle_waiters_--;
     if (shutdown_) break;
   }
 
   return false;
 }
 
+bool Scheduler::SpinForWork(WorkerThread* worker) {
+  int budget = worker->spin_budget_;
+  for (int i = 0; i < budget; i++) {
+    if (!ready_queue_.IsEmpty() || pause_ || shutdown_) {
+      worker->spin_budget_ = NextSpinBudget(budget, true);
+      return true;
+    }
+  }
+  worker->spin_budget_ = NextSpinBudget(budget, false);
+  return false;
+}
+
+int Scheduler::NextSpinBudget(int budget, bool found_work) {
+  // Spinning paid off, so allow longer spins again.
+  if (found_work) return Utils::Minimum(budget * 2 + 1, Flags::idle_spin_count);
+  // Spin less next time, so mostly idle programs do not burn CPU time. Keep
+  // polling at least once, or finding work could never grow the budget.
+  return budget > 1 ? budget / 2 : budget;
+}
+
 void Scheduler::PauseInterpreterLoop() {
   pause_ = true;
   NotifyInterpreterThread();
@@ -437,6 +499,7 @@ Process* Scheduler::InterpretProcess(Process* process, WorkerThread* worker) {
     return NULL;
   }
 
+  process->set_bytecode_counters(worker->bytecode_counters());
   EnterDart(process);
   Interpreter interpreter(process);
   interpreter.Run();
@@ -468,19 +531,21 @@ Process* Scheduler::InterpretProcess(Process* process, WorkerThread* worker) {
     // process, consider returning that process.
     bool terminate = result.ShouldTerminate();
 
-    if (target->ChangeState(Process::kSleeping, Process::kRunning)) {
+    if (target->ChangeState(Process::kSleeping, Process::kRunning) ||
+        ready_queue_.TryDequeueEntry(target)) {
       port->Unlock();
-      RescheduleProcess(process, terminate);
+      ASSERT(target->state() == Process::kRunning);
+      ParkProcess(process, terminate, worker);
       return target;
-    } else {
-      if (ready_queue_.TryDequeueEntry(target)) {
-        port->Unlock();
-        ASSERT(target->state() == Process::kRunning);
-        RescheduleProcess(process, terminate);
-        return target;
-      }
     }
     port->Unlock();
+    if (target == worker->parked_) {
+      // The target handed this thread over to [process]. Swap them so that
+      // the response is handled right away.
+      worker->parked_ = NULL;
+      ParkProcess(process, terminate, worker);
+      return target;
+    }
     RescheduleProcess(process, terminate);
     return NULL;
   }
@@ -518,6 +583,7 @@ Process* Scheduler::InterpretProcess(Process* process, WorkerThread* worker) {
 
 void Scheduler::InterpretNestedProcess(Process* old_process, Process* process) {
   LeaveDart(old_process);
+  process->set_bytecode_counters(old_process->bytecode_counters());
   while (true) {
     Interpreter interpreter(process);
     EnterDart(process);
@@ -702,6 +768,10 @@ void WorkerThread::ThreadExit() {
 }
 
 void Scheduler::NotifyInterpreterThread() {
+  // A spinning worker finds the new work by itself. The increment of
+  // [idle_waiters_] is ordered before the waiter checks the ready queue, so
+  // it is seen here if the waiter could have missed the new work.
+  if (idle_waiters_ == 0) return;
   Monitor* monitor = idle_monitor_;
   monitor->Lock();
   monitor->Notify();
@@ -16,6 +16,7 @@
 
 namespace dartino {
 
+class BytecodeCounters;
 class Heap;
 class Object;
 class Port;
@@ -29,12 +30,29 @@ class WorkerThread {
   explicit WorkerThread(Scheduler* scheduler);
   ~WorkerThread();
 
+  BytecodeCounters* bytecode_counters() const { return bytecode_counters_; }
+
  private:
+  friend class Scheduler;
+
   void RunInThread();
   void ThreadEnter();
   void ThreadExit();
 
   Scheduler* scheduler_;
+  BytecodeCounters* bytecode_counters_;
+
+  // A process that handed this thread to the receiver of its message. It is
+  // resumed on this thread once the receiver is done, which keeps
+  // request/response pairs on the same core. The process stays kRunning
+  // while parked, so it is never scheduled anywhere else.
+  Process* parked_;
+  // Number of processes parked since the last process was taken from the
+  // ready queue.
+  int handoffs_;
+  // Number of times to poll the ready queue before going to sleep. Adapts
+  // to how often spinning finds work, up to [Flags::idle_spin_count].
+  int spin_budget_;
 };
 
 class ProcessVisitor {
@@ -144,6 +162,10 @@ class Scheduler {
   // The stack must already be set up
   void InterpretNestedProcess(Process* old_process, Process* process);
 
+  // Returns the number of polls of the next idle spin, given the [budget] of
+  // the last one and whether it found work.
+  static int NextSpinBudget(int budget, bool found_work);
+
  private:
   friend class Dartino;
   friend class InterpreterExecutionScope;
@@ -170,6 +192,9 @@ class Scheduler {
   InterpretationBarrier interpretation_barrier_;
 
   Monitor* idle_monitor_;
+  // Number of workers sleeping on [idle_monitor_]. Notifications skip the
+  // monitor if it is zero.
+  Atomic<int> idle_waiters_;
   Semaphore interpreter_semaphore_;
 
   DispatchTable dispatch_table_;
@@ -185,8 +210,18 @@ class Scheduler {
 
   void RescheduleProcess(Process* process, bool terminate);
 
+  // Park [process] on [worker] after it handed over the thread, or
+  // reschedule it if the worker has used up its handoffs.
+  void ParkProcess(Process* process, bool terminate, WorkerThread* worker);
+  // Enqueue the parked process of [worker], if any.
+  void UnparkProcess(WorkerThread* worker);
+
   bool RunInterpreterLoop(WorkerThread* worker);
 
+  // Poll the ready queue for a bounded time. Returns true if there is work
+  // or the loop is paused or shut down.
+  bool SpinForWork(WorkerThread* worker);
+
   // Caller must hold [pause_monitor_].
   void PauseInterpreterLoop();
   // Caller must hold [pause_monitor_].
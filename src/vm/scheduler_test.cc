@@ -0,0 +1,34 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/shared/assert.h"
+#include "src/shared/flags.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/scheduler.h"
+
+namespace dartino {
+
+TEST_CASE(SCHEDULER__SPIN_BUDGET_RECOVERS) {
+  int budget = Flags::idle_spin_count;
+  EXPECT(budget > 1);
+
+  // Idle spins shrink the budget down to a single poll, but not below.
+  for (int i = 0; i < 64; i++) {
+    budget = Scheduler::NextSpinBudget(budget, false);
+    EXPECT(budget >= 1);
+  }
+  EXPECT_EQ(1, budget);
+
+  // Finding work grows it back to the maximum.
+  int previous = budget;
+  while (budget < Flags::idle_spin_count) {
+    budget = Scheduler::NextSpinBudget(budget, true);
+    EXPECT(budget > previous);
+    previous = budget;
+  }
+  EXPECT_EQ(Flags::idle_spin_count, budget);
+}
+
+}  // namespace dartino
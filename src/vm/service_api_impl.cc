@@ -4,6 +4,10 @@
 
 #include "src/vm/service_api_impl.h"
 
+#include <string.h>
+
+#include "src/shared/utils.h"
+
 #include "src/vm/natives.h"
 #include "src/vm/port.h"
 #include "src/vm/process.h"
@@ -14,14 +18,29 @@ static const int kRequestHeaderSize = 32;
 
 namespace dartino {
 
+// Services are hashed by name. Lookups of registered services walk the
+// bucket chains without locking; only registration, unregistration and
+// lookups that have to wait for a service take the monitor.
 class ServiceRegistry {
  public:
-  ServiceRegistry() : monitor_(Platform::CreateMonitor()), service_(NULL) {}
+  static const int kBuckets = 256;
+
+  ServiceRegistry() : monitor_(Platform::CreateMonitor()), retired_(NULL) {
+    for (int i = 0; i < kBuckets; i++) buckets_[i] = NULL;
+  }
 
   ~ServiceRegistry() {
-    while (service_ != NULL) {
-      Service* tmp = service_;
-      service_ = service_->next();
+    for (int i = 0; i < kBuckets; i++) {
+      Service* service = buckets_[i];
+      while (service != NULL) {
+        Service* tmp = service;
+        service = service->next();
+        delete tmp;
+      }
+    }
+    while (retired_ != NULL) {
+      Service* tmp = retired_;
+      retired_ = retired_->retired_next();
       delete tmp;
     }
     delete monitor_;
@@ -30,18 +49,21 @@ class ServiceRegistry {
   void Register(Service* service) {
     ScopedMonitorLock lock(monitor_);
     ASSERT(service->next() == NULL);
-    service->set_next(service_);
-    service_ = service;
+    Atomic<Service*>* bucket = BucketFor(service->name());
+    service->set_next(bucket->load(kRelaxed));
+    // Publish the fully initialized service to lock-free readers.
+    bucket->store(service, kRelease);
     monitor_->NotifyAll();
   }
 
   bool Unregister(Service* service) {
     ScopedMonitorLock lock(monitor_);
     ASSERT(service != NULL);
-    if (service_ == service) {
-      service_ = service->next();
+    Atomic<Service*>* bucket = BucketFor(service->name());
+    Service* prev = bucket->load(kRelaxed);
+    if (prev == service) {
+      bucket->store(service->next(), kRelease);
     } else {
-      Service* prev = service_;
       while (prev != NULL && prev->next() != service) {
         prev = prev->next();
       }
@@ -50,46 +72,54 @@ class ServiceRegistry {
       }
       prev->set_next(service->next());
     }
-    delete service;
+    // Concurrent lookups may still be walking past the service, so it is
+    // only deleted with the registry. Its next pointer is kept intact.
+    service->set_retired_next(retired_);
+    retired_ = service;
     return true;
   }
 
+  // Returns the service registered under [name] or NULL. Does not block.
+  Service* TryLookupService(const char* name) {
+    Service* service = BucketFor(name)->load(kAcquire);
+    while (service != NULL && strcmp(name, service->name()) != 0) {
+      service = service->next();
+    }
+    return service;
+  }
+
   Service* LookupService(const char* name) {
+    Service* service = TryLookupService(name);
+    if (service != NULL) return service;
     ScopedMonitorLock lock(monitor_);
-    Service* service;
-    while ((service = FindService(name)) == NULL) {
+    while ((service = TryLookupService(name)) == NULL) {
       monitor_->Wait();
     }
     return service;
   }
 
  private:
-  Service* FindService(const char* name) {
-    for (Service* next = service_; next != NULL; next = next->next()) {
-      if (strcmp(name, next->name()) == 0) {
-        return next;
-      }
-    }
-    return NULL;
+  Atomic<Service*>* BucketFor(const char* name) {
+    uint32 hash = Utils::StringHash(reinterpret_cast<const uint8*>(name),
+                                    strlen(name), 1);
+    return &buckets_[hash & (kBuckets - 1)];
   }
 
   Monitor* monitor_;
-  Service* service_;
+  Atomic<Service*> buckets_[kBuckets];
+  // Unregistered services, linked through their retired next pointers.
+  Service* retired_;
 };
 
 static ServiceRegistry* service_registry = NULL;
 
-struct ServiceRequest {
-  int method_id;
-  bool has_result;
-  ThreadIdentifier thread;
-  Service* service;
-  void* callback;
-};
-
 void PostResultToService(char* buffer) {
   ServiceRequest* request = reinterpret_cast<ServiceRequest*>(buffer);
-  if (request->callback == NULL) {
+  if (request->is_queued) {
+    ServiceCompletionQueue* queue =
+        reinterpret_cast<ServiceCompletionQueue*>(request->callback);
+    queue->Add(request);
+  } else if (request->callback == NULL) {
     request->service->NotifyResult(request);
   } else {
     ServiceApiCallback callback =
@@ -103,7 +133,8 @@ Service::Service(char* name, Port* port)
     : result_monitor_(Platform::CreateMonitor()),
       name_(name),
       port_(port),
-      next_(NULL) {
+      next_(NULL),
+      retired_next_(NULL) {
   port_->IncrementRef();
 }
 
@@ -136,7 +167,7 @@ void Service::Invoke(int id, void* buffer, int size) {
   ServiceRequest* request = reinterpret_cast<ServiceRequest*>(buffer);
   request->method_id = id;
   request->has_result = false;
-  request->thread = ThreadIdentifier();
+  request->is_queued = false;
   request->service = this;
   request->callback = NULL;
   process->mailbox()->EnqueueForeign(port_, buffer, size, false);
@@ -146,6 +177,28 @@ void Service::Invoke(int id, void* buffer, int size) {
 
 void Service::InvokeAsync(int id, ServiceApiCallback callback, void* buffer,
                           int size) {
+  ASSERT(sizeof(ServiceRequest) <= kRequestHeaderSize);
+  ServiceRequest* request = reinterpret_cast<ServiceRequest*>(buffer);
+  request->method_id = id;
+  request->has_result = false;
+  request->is_queued = false;
+  request->callback = reinterpret_cast<void*>(callback);
+  Post(request, size);
+}
+
+void Service::InvokeQueued(int id, ServiceCompletionQueue* queue,
+                           void* buffer, int size) {
+  ASSERT(sizeof(ServiceRequest) <= kRequestHeaderSize);
+  ServiceRequest* request = reinterpret_cast<ServiceRequest*>(buffer);
+  request->method_id = id;
+  request->has_result = false;
+  request->is_queued = true;
+  request->service = this;
+  request->callback = queue;
+  Post(request, size);
+}
+
+void Service::Post(ServiceRequest* request, int size) {
   port_->Lock();
   Process* process = port_->process();
   if (process == NULL) {
@@ -153,16 +206,81 @@ void Service::InvokeAsync(int id, ServiceApiCallback callback, void* buffer,
     port_->Unlock();
     return;
   }
-  ASSERT(sizeof(ServiceRequest) <= kRequestHeaderSize);
-  ServiceRequest* request = reinterpret_cast<ServiceRequest*>(buffer);
-  request->method_id = id;
-  request->has_result = false;
-  request->callback = reinterpret_cast<void*>(callback);
-  process->mailbox()->EnqueueForeign(port_, buffer, size, false);
+  process->mailbox()->EnqueueForeign(port_, request, size, false);
   process->program()->scheduler()->ResumeProcess(process);
   port_->Unlock();
 }
 
+ServiceCompletionQueue::ServiceCompletionQueue()
+    : completed_(NULL),
+      waiters_(0),
+      monitor_(Platform::CreateMonitor()),
+      ready_(NULL) {}
+
+ServiceCompletionQueue::~ServiceCompletionQueue() {
+  ASSERT(completed_ == NULL);
+  ASSERT(waiters_ == 0);
+  delete monitor_;
+}
+
+void ServiceCompletionQueue::Add(ServiceRequest* request) {
+  request->has_result = true;
+  ServiceRequest* head = completed_;
+  do {
+    request->next = head;
+  } while (!completed_.compare_exchange_weak(head, request));
+  // Adding the request and reading the number of waiters are both
+  // sequentially consistent, so either a blocking thread sees the request
+  // before it waits or it is counted here.
+  if (waiters_ > 0) {
+    ScopedMonitorLock lock(monitor_);
+    monitor_->NotifyAll();
+  }
+}
+
+int ServiceCompletionQueue::Poll(void** buffers, int max) {
+  ScopedSpinlock locker(&poll_lock_);
+  if (ready_ == NULL && completed_ != NULL) {
+    // Reverse the taken requests to get them in completion order.
+    ServiceRequest* request = completed_.exchange(NULL);
+    while (request != NULL) {
+      ServiceRequest* next = request->next;
+      request->next = ready_;
+      ready_ = request;
+      request = next;
+    }
+  }
+  int count = 0;
+  while (count < max && ready_ != NULL) {
+    buffers[count++] = ready_;
+    ready_ = ready_->next;
+  }
+  return count;
+}
+
+bool ServiceCompletionQueue::HasCompleted() {
+  if (completed_ != NULL) return true;
+  // Another thread may have moved the requests to [ready_] and left some of
+  // them there. Taking the lock waits for it to finish doing so.
+  ScopedSpinlock locker(&poll_lock_);
+  return ready_ != NULL;
+}
+
+int ServiceCompletionQueue::Wait(void** buffers, int max, int spin_count) {
+  for (int i = 0; i < spin_count; i++) {
+    int count = Poll(buffers, max);
+    if (count > 0) return count;
+  }
+  while (true) {
+    int count = Poll(buffers, max);
+    if (count > 0) return count;
+    ScopedMonitorLock lock(monitor_);
+    ++waiters_;
+    while (!HasCompleted()) monitor_->Wait();
+    --waiters_;
+  }
+}
+
 BEGIN_NATIVE(ServiceRegister) {
   if (!arguments[1]->IsInstance()) return Failure::illegal_state();
   Instance* port_instance = Instance::cast(arguments[1]);
@@ -193,6 +311,12 @@ ServiceId ServiceApiLookup(const char* name) {
   return reinterpret_cast<ServiceId>(service);
 }
 
+ServiceId ServiceApiTryLookup(const char* name) {
+  dartino::Service* service =
+      dartino::service_registry->TryLookupService(name);
+  return reinterpret_cast<ServiceId>(service);
+}
+
 void ServiceApiInvoke(ServiceId service_id, MethodId method, void* buffer,
                       int size) {
   dartino::Service* service = reinterpret_cast<dartino::Service*>(service_id);
@@ -208,6 +332,38 @@ void ServiceApiInvokeAsync(ServiceId service_id, MethodId method,
   service->InvokeAsync(method_id, callback, buffer, size);
 }
 
+ServiceQueueId ServiceApiCreateCompletionQueue() {
+  return reinterpret_cast<ServiceQueueId>(
+      new dartino::ServiceCompletionQueue());
+}
+
+void ServiceApiDeleteCompletionQueue(ServiceQueueId queue_id) {
+  delete reinterpret_cast<dartino::ServiceCompletionQueue*>(queue_id);
+}
+
+void ServiceApiInvokeQueued(ServiceId service_id, MethodId method,
+                            ServiceQueueId queue_id, void* buffer, int size) {
+  dartino::Service* service = reinterpret_cast<dartino::Service*>(service_id);
+  intptr_t method_id = reinterpret_cast<intptr_t>(method);
+  dartino::ServiceCompletionQueue* queue =
+      reinterpret_cast<dartino::ServiceCompletionQueue*>(queue_id);
+  service->InvokeQueued(method_id, queue, buffer, size);
+}
+
+int ServiceApiPollCompletions(ServiceQueueId queue_id, void** buffers,
+                              int max) {
+  dartino::ServiceCompletionQueue* queue =
+      reinterpret_cast<dartino::ServiceCompletionQueue*>(queue_id);
+  return queue->Poll(buffers, max);
+}
+
+int ServiceApiWaitForCompletions(ServiceQueueId queue_id, void** buffers,
+                                 int max, int spin_count) {
+  dartino::ServiceCompletionQueue* queue =
+      reinterpret_cast<dartino::ServiceCompletionQueue*>(queue_id);
+  return queue->Wait(buffers, max, spin_count);
+}
+
 void ServiceApiTerminate(ServiceId service_id) {
   char buffer[kRequestHeaderSize];
   ServiceApiInvoke(service_id, kTerminateMethodId, buffer, sizeof(buffer));
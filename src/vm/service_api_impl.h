@@ -7,11 +7,30 @@
 
 #include "include/service_api.h"
 
+#include "src/shared/atomic.h"
+
+#include "src/vm/spinlock.h"
+
 namespace dartino {
 
 class Monitor;
 class Port;
-struct ServiceRequest;
+class Service;
+class ServiceCompletionQueue;
+
+// The header at the start of every request buffer. Clients reserve
+// kRequestHeaderSize bytes for it.
+struct ServiceRequest {
+  int method_id;
+  bool has_result;
+  bool is_queued;
+  // Links requests in a completion queue.
+  ServiceRequest* next;
+  Service* service;
+  // The ServiceApiCallback for asynchronous requests or the completion
+  // queue for queued requests.
+  void* callback;
+};
 
 // TODO(ager): Instead of making this accessible, we should
 // probably post a callback into dart? Fix the service param;
@@ -32,10 +51,17 @@ class Service {
 
   void InvokeAsync(int id, ServiceApiCallback callback, void* buffer, int size);
 
+  void InvokeQueued(int id, ServiceCompletionQueue* queue, void* buffer,
+                    int size);
+
   char* name() const { return name_; }
 
-  Service* next() const { return next_; }
-  void set_next(Service* next) { next_ = next; }
+  // The next service in the same registry bucket. Read without locking.
+  Service* next() const { return next_.load(kAcquire); }
+  void set_next(Service* next) { next_.store(next, kRelease); }
+
+  Service* retired_next() const { return retired_next_; }
+  void set_retired_next(Service* next) { retired_next_ = next; }
 
  private:
   friend void PostResultToService(char* buffer);
@@ -43,11 +69,51 @@ class Service {
   void NotifyResult(ServiceRequest* request);
   void WaitForResult(ServiceRequest* request);
 
+  // Sends the request without waiting for the result.
+  void Post(ServiceRequest* request, int size);
+
   Monitor* const result_monitor_;
 
   char* const name_;
   Port* const port_;
-  Service* next_;
+  Atomic<Service*> next_;
+  Service* retired_next_;
+};
+
+// Collects the results of queued requests. Results are posted from the
+// Dartino worker threads without taking any locks; a client thread only
+// takes the monitor if it has to block for results.
+class ServiceCompletionQueue {
+ public:
+  ServiceCompletionQueue();
+  // All queued requests must have completed.
+  ~ServiceCompletionQueue();
+
+  // Adds the completed [request] to the queue.
+  void Add(ServiceRequest* request);
+
+  // Moves up to [max] completed request buffers to [buffers] in completion
+  // order and returns how many were moved. Does not block.
+  int Poll(void** buffers, int max);
+
+  // Like Poll, but waits for at least one completed request. The queue is
+  // polled [spin_count] times before the calling thread blocks.
+  int Wait(void** buffers, int max, int spin_count);
+
+ private:
+  // Whether Poll would return any requests.
+  bool HasCompleted();
+
+  // Completed requests, most recent first.
+  Atomic<ServiceRequest*> completed_;
+  // Number of threads blocked on the monitor.
+  Atomic<int> waiters_;
+  Monitor* const monitor_;
+
+  // Completed requests taken off [completed_] but not yet returned, oldest
+  // first. Guarded by [poll_lock_].
+  Spinlock poll_lock_;
+  ServiceRequest* ready_;
 };
 
 }  // namespace dartino
@@ -0,0 +1,98 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/service_api_impl.h"
+#include "src/vm/thread.h"
+
+namespace dartino {
+
+static const int kThreads = 4;
+static const int kRequestsPerThread = 1000;
+
+static ServiceCompletionQueue* queue = NULL;
+static ServiceRequest requests[kThreads][kRequestsPerThread];
+
+static void* CompleteRequests(void* data) {
+  ServiceRequest* thread_requests = static_cast<ServiceRequest*>(data);
+  for (int i = 0; i < kRequestsPerThread; i++) {
+    thread_requests[i].method_id = i;
+    queue->Add(&thread_requests[i]);
+  }
+  return NULL;
+}
+
+static void* WaitForRequests(void* data) {
+  void* buffer;
+  for (int i = 0; i < kRequestsPerThread; i++) {
+    EXPECT_EQ(1, queue->Wait(&buffer, 1, 0));
+  }
+  return NULL;
+}
+
+TEST_CASE(CompletionQueuePoll) {
+  ServiceCompletionQueue queue;
+  ServiceRequest first;
+  ServiceRequest second;
+  void* buffers[2];
+  EXPECT_EQ(0, queue.Poll(buffers, 2));
+  queue.Add(&first);
+  queue.Add(&second);
+  EXPECT(first.has_result);
+  EXPECT_EQ(1, queue.Poll(buffers, 1));
+  EXPECT_EQ(&first, buffers[0]);
+  EXPECT_EQ(1, queue.Poll(buffers, 2));
+  EXPECT_EQ(&second, buffers[0]);
+  EXPECT_EQ(0, queue.Poll(buffers, 2));
+}
+
+// Completes requests from several threads while waiting for them on the
+// main thread. Requests from the same thread are returned in order.
+TEST_CASE(CompletionQueueWait) {
+  queue = new ServiceCompletionQueue();
+  ThreadIdentifier threads[kThreads];
+  for (int i = 0; i < kThreads; i++) {
+    threads[i] = Thread::Run(CompleteRequests, requests[i]);
+  }
+  int next[kThreads] = {0};
+  int received = 0;
+  void* buffers[64];
+  while (received < kThreads * kRequestsPerThread) {
+    int count = queue->Wait(buffers, 64, 100);
+    EXPECT(count > 0 && count <= 64);
+    for (int i = 0; i < count; i++) {
+      ServiceRequest* request = static_cast<ServiceRequest*>(buffers[i]);
+      int thread = (request - &requests[0][0]) / kRequestsPerThread;
+      EXPECT_EQ(next[thread]++, request->method_id);
+    }
+    received += count;
+  }
+  for (int i = 0; i < kThreads; i++) threads[i].Join();
+  delete queue;
+  queue = NULL;
+}
+
+// Waits for requests one at a time on several threads. Requests left in
+// the queue by one waiter must wake up the others.
+TEST_CASE(CompletionQueueConcurrentWait) {
+  queue = new ServiceCompletionQueue();
+  ThreadIdentifier waiters[kThreads];
+  for (int i = 0; i < kThreads; i++) {
+    waiters[i] = Thread::Run(WaitForRequests, NULL);
+  }
+  ThreadIdentifier threads[kThreads];
+  for (int i = 0; i < kThreads; i++) {
+    threads[i] = Thread::Run(CompleteRequests, requests[i]);
+  }
+  for (int i = 0; i < kThreads; i++) threads[i].Join();
+  for (int i = 0; i < kThreads; i++) waiters[i].Join();
+  void* buffer;
+  EXPECT_EQ(0, queue->Poll(&buffer, 1));
+  delete queue;
+  queue = NULL;
+}
+
+}  // namespace dartino
@@ -868,6 +868,28 @@ SessionState* SessionState::ProcessMessage(Connection::Opcode opcode) {
       break;
     }
 
+    case Connection::kBytecodeProfile: {
+      ASSERT(!IsScheduled() || IsPaused());
+      // Sum the function counts of all live processes.
+      HashMap<Function*, uint64> functions;
+      for (auto process : *program()->process_list()) {
+        FunctionCounters* counters = process->function_counters();
+        if (counters == NULL) continue;
+        for (int i = 0; i < counters->length(); i++) {
+          functions[counters->function_at(i)] += counters->count_at(i);
+        }
+      }
+      WriteBuffer buffer;
+      BytecodeProfiler::WriteOpcodeCounts(&buffer);
+      buffer.WriteInt(functions.size());
+      for (auto& pair : functions) {
+        buffer.WriteInt64(session()->FunctionMessage(pair.first));
+        buffer.WriteInt64(pair.second);
+      }
+      connection()->Send(Connection::kBytecodeProfileResult, buffer);
+      break;
+    }
+
 #ifdef DARTINO_ENABLE_LIVE_CODING
     case Connection::kSetEntryPoint: {
       program()->set_entry(Function::cast(session()->Pop()));
@@ -0,0 +1,131 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/vm/socket_stream.h"
+
+#if defined(DARTINO_TARGET_OS_POSIX)
+#include <errno.h>
+#include <sys/uio.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/shared/utils.h"
+
+namespace dartino {
+
+SocketStream::SocketStream(Port* port, int capacity)
+    : EventRegistration(port),
+      buffer_(static_cast<uint8*>(malloc(capacity))),
+      capacity_(capacity),
+      head_(0),
+      tail_(0),
+      stalled_(false),
+      closed_(false),
+      error_(0) {
+  ASSERT(Utils::IsPowerOfTwo(capacity));
+  ASSERT(capacity >= kMinCapacity && capacity <= kMaxCapacity);
+}
+
+SocketStream::~SocketStream() { free(buffer_); }
+
+void SocketStream::Deliver(int64 value, WakeupBatch* batch) {
+  if ((value & (EventHandler::READ_EVENT | EventHandler::CLOSE_EVENT |
+                EventHandler::ERROR_EVENT)) != 0) {
+    // Readable now means there is data in the ring.
+    value = (value & ~EventHandler::READ_EVENT) | Fill();
+  }
+  EventRegistration::Deliver(value, batch);
+}
+
+int64 SocketStream::Read(uint8* destination, int64 length) {
+  int64 available = Available();
+  if (length > available) length = available;
+  int offset = static_cast<int>(head_ & (capacity_ - 1));
+  int64 first = Utils::Minimum<int64>(length, capacity_ - offset);
+  memcpy(destination, buffer_ + offset, first);
+  memcpy(destination + first, buffer_, length - first);
+  Consume(length);
+  return length;
+}
+
+void SocketStream::Consume(int64 length) {
+  ASSERT(length >= 0 && length <= Available());
+  head_ += length;
+  // The refill may drain the socket, which then reports no new events, so
+  // the owner has to see the data it adds.
+  if (stalled_) MarkReady(Fill());
+}
+
+#if defined(DARTINO_TARGET_OS_POSIX)
+
+int64 SocketStream::Fill() {
+  ScopedSpinlock locker(&fill_lock_);
+  stalled_ = false;
+  while (!closed_ && error_ == 0) {
+    uint64 tail = tail_;
+    int64 free = capacity_ - static_cast<int64>(tail - head_);
+    if (free == 0) {
+      // The owner checks [stalled_] after consuming, so check for space
+      // again after setting it.
+      stalled_ = true;
+      if (capacity_ - static_cast<int64>(tail - head_) == 0) break;
+      stalled_ = false;
+      continue;
+    }
+    int offset = static_cast<int>(tail & (capacity_ - 1));
+    int64 first = Utils::Minimum<int64>(free, capacity_ - offset);
+    struct iovec iov[2];
+    iov[0].iov_base = buffer_ + offset;
+    iov[0].iov_len = first;
+    iov[1].iov_base = buffer_;
+    iov[1].iov_len = free - first;
+    ssize_t result = readv(id(), iov, free == first ? 1 : 2);
+    if (result > 0) {
+      tail_ = tail + result;
+    } else if (result == 0) {
+      closed_ = true;
+    } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      break;
+    } else if (errno != EINTR) {
+      error_ = errno;
+    }
+  }
+  int64 events = 0;
+  if (Available() > 0) events |= EventHandler::READ_EVENT;
+  if (closed_) events |= EventHandler::CLOSE_EVENT;
+  if (error_ != 0) events |= EventHandler::ERROR_EVENT;
+  return events;
+}
+
+int64 SocketStream::Write(const word* iovecs, int count) {
+  ASSERT(count >= 0 && count <= kMaxIovecs);
+  struct iovec iov[kMaxIovecs];
+  for (int i = 0; i < count; i++) {
+    iov[i].iov_base = reinterpret_cast<void*>(iovecs[2 * i]);
+    iov[i].iov_len = iovecs[2 * i + 1];
+  }
+  while (true) {
+    ssize_t result = writev(id(), iov, count);
+    if (result >= 0) return result;
+    if (errno != EINTR) return -errno;
+  }
+}
+
+#else  // defined(DARTINO_TARGET_OS_POSIX)
+
+int64 SocketStream::Fill() {
+  UNIMPLEMENTED();
+  return 0;
+}
+
+int64 SocketStream::Write(const word* iovecs, int count) {
+  UNIMPLEMENTED();
+  return -1;
+}
+
+#endif  // defined(DARTINO_TARGET_OS_POSIX)
+
+}  // namespace dartino
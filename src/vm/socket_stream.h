@@ -0,0 +1,76 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_SOCKET_STREAM_H_
+#define SRC_VM_SOCKET_STREAM_H_
+
+#include "src/shared/atomic.h"
+#include "src/shared/globals.h"
+#include "src/vm/event_handler.h"
+#include "src/vm/spinlock.h"
+
+namespace dartino {
+
+// A persistent registration of a socket that buffers the received data in a
+// ring. The event handler thread reads into the ring when the socket becomes
+// readable, so the owning process finds the data there without a system
+// call. The owning process is the only consumer.
+//
+// The ring is only filled up to its capacity. The rest of the data is read
+// once the owner has consumed some of it, as the socket will not report it
+// again.
+class SocketStream : public EventRegistration {
+ public:
+  static const int kMinCapacity = 256;
+  static const int kMaxCapacity = 1 << 24;
+  static const int kMaxIovecs = 16;
+
+  // [capacity] must be a power of two between kMinCapacity and kMaxCapacity.
+  SocketStream(Port* port, int capacity);
+  ~SocketStream();
+
+  void Deliver(int64 value, WakeupBatch* batch);
+  bool IsSocketStream() const { return true; }
+
+  uint8* buffer() const { return buffer_; }
+  int capacity() const { return capacity_; }
+
+  // The number of bytes in the ring.
+  int64 Available() const { return tail_ - head_; }
+
+  // Copies up to [length] bytes from the ring to [destination] and
+  // consumes them. Returns the number of bytes copied.
+  int64 Read(uint8* destination, int64 length);
+
+  // Drops the first [length] bytes of the ring.
+  void Consume(int64 length);
+
+  // Writes the [count] buffers described by pairs of addresses and lengths
+  // in [iovecs] with a single system call. Returns the number of bytes
+  // written or a negative errno value.
+  int64 Write(const word* iovecs, int count);
+
+ private:
+  // Reads from the socket until it would block or the ring is full.
+  // Returns the events to report.
+  int64 Fill();
+
+  uint8* const buffer_;
+  const int capacity_;
+  // The number of bytes consumed and received so far. The ring holds the
+  // bytes in between.
+  Atomic<uint64> head_;
+  Atomic<uint64> tail_;
+  // Set if the ring got full before the socket was drained.
+  Atomic<bool> stalled_;
+  bool closed_;
+  int error_;
+  // Held while filling, which happens both on the event handler thread and
+  // on the owner's thread after consuming from a full ring.
+  Spinlock fill_lock_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_SOCKET_STREAM_H_
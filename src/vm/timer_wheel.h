@@ -0,0 +1,260 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#ifndef SRC_VM_TIMER_WHEEL_H_
+#define SRC_VM_TIMER_WHEEL_H_
+
+#include "src/shared/assert.h"
+#include "src/shared/globals.h"
+#include "src/vm/hash_map.h"
+
+namespace dartino {
+
+// A hashed hierarchical timer wheel with at most one timer per value.
+// Scheduling and cancelling a timer take constant time. Time is measured in
+// microseconds and timers expire with a resolution of one tick.
+//
+// Level 0 has a slot per tick for the next kSlots ticks. Each higher level
+// has slots covering kSlots times as many ticks, and the timers of a slot
+// are moved to the level below when the wheel gets to it. Timers further
+// out than the top level are moved along with the top level until they get
+// into range.
+template <typename V>
+class TimerWheel {
+ public:
+  static const int kTickBits = 6;
+  static const int kLevelBits = 8;
+  static const int kLevels = 4;
+  static const int kSlots = 1 << kLevelBits;
+
+  TimerWheel() : current_tick_(0), count_(0), free_(NULL) {
+    for (int i = 0; i < kLevels; i++) {
+      for (int j = 0; j < kSlots; j++) slots_[i][j].Clear();
+      level_counts_[i] = 0;
+    }
+    expired_.Clear();
+  }
+
+  ~TimerWheel() {
+    for (auto it = index_.Begin(); it != index_.End(); ++it) {
+      delete it->second;
+    }
+    while (free_ != NULL) {
+      Entry* next = static_cast<Entry*>(free_->next);
+      delete free_;
+      free_ = next;
+    }
+  }
+
+  bool IsEmpty() { return index_.size() == 0; }
+
+  bool Contains(const V& value) { return index_.Find(value) != index_.End(); }
+
+  // Schedules the timer for [value] to expire at [deadline], replacing its
+  // previous deadline. [now] is the current time. Returns true if there was
+  // no timer for [value].
+  bool Schedule(int64 deadline, const V& value, int64 now) {
+    // An empty wheel does not advance, so catch up with the current time
+    // to not step through every tick since it was last used.
+    if (count_ == 0) {
+      int64 next_tick = (now >> kTickBits) + 1;
+      if (next_tick > current_tick_) current_tick_ = next_tick;
+    }
+    Entry* entry;
+    bool is_new;
+    auto it = index_.Find(value);
+    if (it == index_.End()) {
+      entry = Allocate();
+      entry->value = value;
+      index_[value] = entry;
+      is_new = true;
+    } else {
+      entry = it->second;
+      Unlink(entry);
+      is_new = false;
+    }
+    // Round up, so a timer never expires before its deadline.
+    entry->tick = (deadline + (1 << kTickBits) - 1) >> kTickBits;
+    Place(entry);
+    count_++;
+    return is_new;
+  }
+
+  // Cancels the timer for [value]. Returns false if there was none.
+  bool Cancel(const V& value) {
+    auto it = index_.Find(value);
+    if (it == index_.End()) return false;
+    Entry* entry = it->second;
+    index_.Erase(it);
+    Unlink(entry);
+    Free(entry);
+    return true;
+  }
+
+  // Removes a timer that expired by [now] and stores its value in [value].
+  // Returns false if there is none.
+  bool RemoveExpired(int64 now, V* value) {
+    if (expired_.IsEmpty()) Advance(now);
+    if (expired_.IsEmpty()) return false;
+    Entry* entry = static_cast<Entry*>(expired_.next);
+    *value = entry->value;
+    Cancel(entry->value);
+    return true;
+  }
+
+  // Returns a time no later than the time the first timer expires, or
+  // INT64_MAX if there are no timers. The time is exact if no timer on the
+  // higher levels is moved down before the first timer on level 0 expires.
+  int64 NextDeadline() {
+    if (!expired_.IsEmpty()) return 0;
+    if (count_ == 0) return INT64_MAX;
+    int64 result = INT64_MAX;
+    for (int i = 0; i < kSlots; i++) {
+      int64 tick = current_tick_ + i;
+      if (!slots_[0][tick & (kSlots - 1)].IsEmpty()) {
+        result = tick << kTickBits;
+        break;
+      }
+    }
+    // The timers of the higher levels expire no earlier than their slot is
+    // moved to the level below.
+    for (int level = 1; level < kLevels; level++) {
+      if (level_counts_[level] == 0) continue;
+      int shift = level * kLevelBits;
+      int64 base = current_tick_ >> shift;
+      // The current slot is only moved if the wheel is at its start.
+      int first = (current_tick_ & ((1LL << shift) - 1)) == 0 ? 0 : 1;
+      for (int k = first; k < first + kSlots; k++) {
+        if (!slots_[level][(base + k) & (kSlots - 1)].IsEmpty()) {
+          int64 deadline = ((base + k) << shift) << kTickBits;
+          if (deadline < result) result = deadline;
+          break;
+        }
+      }
+    }
+    return result;
+  }
+
+ private:
+  struct Link {
+    Link* previous;
+    Link* next;
+
+    void Clear() { previous = next = this; }
+    bool IsEmpty() const { return next == this; }
+
+    void Unlink() {
+      previous->next = next;
+      next->previous = previous;
+    }
+
+    void InsertBefore(Link* link) {
+      previous = link->previous;
+      next = link;
+      link->previous->next = this;
+      link->previous = this;
+    }
+  };
+
+  struct Entry : public Link {
+    int64 tick;
+    V value;
+    // The level of the slot holding the entry, or -1 if it has expired.
+    int level;
+  };
+
+  // Removes [entry] from its slot or the expired list.
+  void Unlink(Entry* entry) {
+    if (entry->level >= 0) {
+      level_counts_[entry->level]--;
+      count_--;
+    }
+    entry->Unlink();
+  }
+
+  Entry* Allocate() {
+    if (free_ == NULL) return new Entry();
+    Entry* entry = free_;
+    free_ = static_cast<Entry*>(entry->next);
+    return entry;
+  }
+
+  void Free(Entry* entry) {
+    entry->next = free_;
+    free_ = entry;
+  }
+
+  // Puts [entry] into the slot covering its tick.
+  void Place(Entry* entry) {
+    if (entry->tick < current_tick_) entry->tick = current_tick_;
+    int64 delta = entry->tick - current_tick_;
+    int level = 0;
+    while (level < kLevels - 1 &&
+           delta >= (1LL << ((level + 1) * kLevelBits))) {
+      level++;
+    }
+    int index = (entry->tick >> (level * kLevelBits)) & (kSlots - 1);
+    entry->InsertBefore(&slots_[level][index]);
+    entry->level = level;
+    level_counts_[level]++;
+  }
+
+  // Moves the timers of the current slot of [level] to the levels below.
+  void Cascade(int level) {
+    int index = (current_tick_ >> (level * kLevelBits)) & (kSlots - 1);
+    if (index == 0 && level < kLevels - 1) Cascade(level + 1);
+    Link* slot = &slots_[level][index];
+    Link* link = slot->next;
+    slot->Clear();
+    while (link != slot) {
+      Link* next = link->next;
+      level_counts_[level]--;
+      Place(static_cast<Entry*>(link));
+      link = next;
+    }
+  }
+
+  // Moves the timers that expired by [now] to the expired list.
+  void Advance(int64 now) {
+    int64 now_tick = now >> kTickBits;
+    while (count_ > 0 && current_tick_ <= now_tick) {
+      int index = current_tick_ & (kSlots - 1);
+      if (index == 0) Cascade(1);
+      if (level_counts_[0] == 0) {
+        // Nothing can expire before the next slot of the lowest non-empty
+        // level is moved down, so skip to it.
+        int level = 1;
+        while (level < kLevels - 1 && level_counts_[level] == 0) level++;
+        int shift = level * kLevelBits;
+        int64 next_tick = ((current_tick_ >> shift) + 1) << shift;
+        current_tick_ = next_tick <= now_tick ? next_tick : now_tick + 1;
+        continue;
+      }
+      Link* slot = &slots_[0][index];
+      while (!slot->IsEmpty()) {
+        Entry* entry = static_cast<Entry*>(slot->next);
+        Unlink(entry);
+        entry->level = -1;
+        entry->InsertBefore(&expired_);
+      }
+      current_tick_++;
+    }
+    if (count_ == 0 && current_tick_ <= now_tick) current_tick_ = now_tick + 1;
+  }
+
+  // The next tick whose timers have not expired yet.
+  int64 current_tick_;
+  // The number of timers in the slots, in total and per level.
+  int count_;
+  int level_counts_[kLevels];
+
+  Link slots_[kLevels][kSlots];
+  Link expired_;
+  HashMap<V, Entry*> index_;
+  Entry* free_;
+};
+
+}  // namespace dartino
+
+#endif  // SRC_VM_TIMER_WHEEL_H_
@@ -0,0 +1,89 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+#include "src/shared/assert.h"
+#include "src/shared/test_case.h"
+
+#include "src/vm/timer_wheel.h"
+
+namespace dartino {
+
+static const int64 kTick = 1 << TimerWheel<word>::kTickBits;
+static const int64 kStart = 1000000000;
+
+TEST_CASE(TIMER_WHEEL__EXPIRES_IN_ORDER) {
+  TimerWheel<word> wheel;
+  // Deadlines on all levels, scheduled in reverse.
+  const int64 kDeadlines[] = {kTick * 3, kTick * 300, kTick * 70000,
+                              kTick * 20000000, kTick * 5000000000LL};
+  const int kCount = ARRAY_SIZE(kDeadlines);
+  for (int i = kCount - 1; i >= 0; i--) {
+    EXPECT(wheel.Schedule(kStart + kDeadlines[i], i, kStart));
+  }
+  int64 now = kStart;
+  for (int i = 0; i < kCount; i++) {
+    word value;
+    // Nothing expires before its deadline.
+    while (true) {
+      int64 next = wheel.NextDeadline();
+      EXPECT(next <= kStart + kDeadlines[i]);
+      if (next >= kStart + kDeadlines[i]) break;
+      now = next;
+      EXPECT(!wheel.RemoveExpired(now, &value));
+    }
+    EXPECT(!wheel.RemoveExpired(kStart + kDeadlines[i] - 1, &value));
+    now = kStart + kDeadlines[i];
+    EXPECT(wheel.RemoveExpired(now, &value));
+    EXPECT_EQ(i, value);
+    EXPECT(!wheel.RemoveExpired(now, &value));
+  }
+  EXPECT(wheel.IsEmpty());
+  EXPECT_EQ(INT64_MAX, wheel.NextDeadline());
+}
+
+TEST_CASE(TIMER_WHEEL__RESCHEDULE_AND_CANCEL) {
+  TimerWheel<word> wheel;
+  for (word i = 0; i < 1000; i++) {
+    EXPECT(wheel.Schedule(kStart + i * kTick, i, kStart));
+  }
+  // Push the even timers out and cancel every third.
+  for (word i = 0; i < 1000; i += 2) {
+    EXPECT(!wheel.Schedule(kStart + (2000 + i) * kTick, i, kStart));
+  }
+  for (word i = 0; i < 1000; i += 3) {
+    EXPECT(wheel.Cancel(i));
+    EXPECT(!wheel.Contains(i));
+  }
+  EXPECT(!wheel.Cancel(0));
+
+  word value;
+  int expired = 0;
+  word last = -1;
+  while (wheel.RemoveExpired(kStart + 999 * kTick, &value)) {
+    EXPECT((value & 1) == 1);
+    EXPECT(value % 3 != 0);
+    EXPECT(value > last);
+    last = value;
+    expired++;
+  }
+  EXPECT_EQ(333, expired);
+  while (wheel.RemoveExpired(kStart + 3000 * kTick, &value)) {
+    EXPECT((value & 1) == 0);
+    expired++;
+  }
+  EXPECT_EQ(666, expired);
+  EXPECT(wheel.IsEmpty());
+}
+
+TEST_CASE(TIMER_WHEEL__PAST_DEADLINE) {
+  TimerWheel<word> wheel;
+  word value;
+  EXPECT(!wheel.RemoveExpired(kStart, &value));
+  EXPECT(wheel.Schedule(kStart - kTick * 10, 7, kStart));
+  EXPECT(wheel.NextDeadline() <= kStart + kTick);
+  EXPECT(wheel.RemoveExpired(kStart + kTick, &value));
+  EXPECT_EQ(7, value);
+}
+
+}  // namespace dartino
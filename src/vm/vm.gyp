@@ -46,6 +46,11 @@
         }],
       ],
       'sources': [
+        'blocking_call_pool.cc',
+        'blocking_call_pool.h',
+        'bytecode_profiler.cc',
+        'bytecode_profiler.h',
+        'catch_block_cache.h',
         'dartino_api_impl.cc',
         'dartino_api_impl.h',
         'dartino.cc',
@@ -64,6 +69,8 @@
         'event_handler_macos.cc',
         'event_handler_posix.cc',
         'event_handler_windows.cc',
+        'file_transfer.cc',
+        'file_transfer.h',
         'gc_metadata.cc',
         'gc_metadata.h',
         'hash_map.h',
@@ -96,6 +103,8 @@
         'natives_windows.cc',
         'object.cc',
         'object.h',
+        'object_graph_copier.cc',
+        'object_graph_copier.h',
         'object_list.cc',
         'object_list.h',
         'object_map.cc',
@@ -113,6 +122,8 @@
         'process_handle.cc',
         'process_handle.h',
         'process_queue.h',
+        'program_channel.cc',
+        'program_channel.h',
         'program.cc',
         'program_folder.cc',
         'program_folder.h',
@@ -122,6 +133,8 @@
         'program.h',
         'program_info_block.cc',
         'program_info_block.h',
+        'resolver.cc',
+        'resolver.h',
         'scheduler.cc',
         'scheduler.h',
         'selector_row.cc',
@@ -136,6 +149,8 @@
         'snapshot.h',
         'socket_connection_api_impl.cc',
         'socket_connection_api_impl.h',
+        'socket_stream.cc',
+        'socket_stream.h',
         'sort.cc',
         'sort.h',
         'thread_cmsis.cc',
@@ -149,6 +164,7 @@
         'thread_posix.h',
         'thread_windows.cc',
         'thread_windows.h',
+        'timer_wheel.h',
         'unicode.cc',
         'unicode.h',
         'vector.cc',
@@ -363,6 +379,9 @@
         'object_test.cc',
         'platform_test.cc',
         'priority_heap_test.cc',
+        'scheduler_test.cc',
+        'service_api_impl_test.cc',
+        'timer_wheel_test.cc',
         'vector_test.cc',
       ],
     },
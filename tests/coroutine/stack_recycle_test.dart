@@ -0,0 +1,60 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+// Test that the stacks of finished coroutines and exited fibers can be
+// reused by new ones without affecting live coroutines.
+
+import 'dart:dartino';
+
+import 'package:expect/expect.dart';
+
+main() {
+  testCoroutines();
+  testNestedCoroutines();
+  testFibers();
+}
+
+int recurse(int n) => n == 0 ? 0 : 1 + recurse(n - 1);
+
+testCoroutines() {
+  var live = new Coroutine((x) {
+    while (true) x = Coroutine.yield(x + 1);
+  });
+  for (int i = 0; i < 1000; i++) {
+    // Make some of the recycled stacks grow before they are reused.
+    var co = new Coroutine((x) => recurse(x));
+    Expect.equals(i % 300, co(i % 300));
+    Expect.isTrue(co.isDone);
+    Expect.equals(i + 1, live(i));
+  }
+}
+
+testNestedCoroutines() {
+  var outer = new Coroutine((x) {
+    for (int i = 0; i < 100; i++) {
+      var inner = new Coroutine((y) => y * 2);
+      x = Coroutine.yield(inner(x));
+    }
+    return x;
+  });
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(i * 2, outer(i));
+  }
+  Expect.equals(42, outer(42));
+  Expect.isTrue(outer.isDone);
+}
+
+testFibers() {
+  var results = [];
+  for (int i = 0; i < 1000; i++) {
+    Fiber fiber = Fiber.fork(() {
+      Fiber.yield();
+      return recurse(i % 300);
+    });
+    results.add(fiber);
+  }
+  for (int i = 0; i < 1000; i++) {
+    Expect.equals(i % 300, results[i].join());
+  }
+}
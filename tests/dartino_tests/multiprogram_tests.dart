@@ -88,6 +88,14 @@ Future<Map<String, NoArgFuture>> listTests() async {
             'immutable_gc', 0,
         ], duplicate: 2),
 
+    // The two programs only communicate through program channels, so they
+    // must run at the same time.
+    'multiprogram_tests/program_channel':
+        () => runTest('parallel', [
+            'program_channel_receiver', 0,
+            'program_channel_sender', 0,
+        ]),
+
     'multiprogram_tests/mutable_gc_and_freeze':
         () => runTest('batch=6', [
             'mutable_gc', 0,
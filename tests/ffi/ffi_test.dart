@@ -45,6 +45,7 @@ main() {
   testNestedFfiCalls();
   testOutOfResources();
   testDoubleFree();
+  testBlockingCalls();
 }
 
 checkOutOfBoundsThrows(function) {
@@ -1120,3 +1121,29 @@ testDoubleFree() {
   // It is an error to free a foreign function twice. No need to test the type.
   Expect.throws(() { f.free(); });
 }
+
+testBlockingCalls() {
+  var libPath = ForeignLibrary.bundleLibraryName('ffi_test_library');
+  ForeignLibrary fl = new ForeignLibrary.fromName(libPath);
+
+  var setcount = fl.lookup('setcount').blocking;
+  var inc = fl.lookup('inc').blocking;
+  Expect.identical(inc, inc.blocking);
+  Expect.equals(41, setcount.icall$1(41));
+  Expect.equals(null, inc.vcall$0());
+  Expect.equals(42, fl.lookup('getcount').icall$0());
+
+  Expect.equals(7, fl.lookup('ifun7').blocking.icall$7(1, 1, 1, 1, 1, 1, 1));
+  Expect.equals(-3, fl.lookup('ifun2').blocking.icall$2(-1, -2));
+
+  var pointer = fl.lookup('pfun2').blocking.pcall$2(42, 43);
+  var memory = new ForeignMemory.fromAddress(pointer.address, 16);
+  Expect.equals(42, memory.getInt32(0));
+  Expect.equals(43, memory.getInt32(12));
+  memory.free();
+
+  // The errno of the call is passed back to the caller.
+  const EBADF = 9;
+  Expect.equals(-1, ForeignLibrary.main.lookup('close').blocking.icall$1(-1));
+  Expect.equals(EBADF, Foreign.errno);
+}
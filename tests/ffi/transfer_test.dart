@@ -0,0 +1,62 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino.ffi';
+import 'dart:dartino';
+
+import 'package:expect/expect.dart';
+
+main() {
+  testTransferToOtherProcess(true);
+  testTransferToOtherProcess(false);
+  testTransferToSelf();
+  testTransferErrors();
+}
+
+testTransferToOtherProcess(bool finalized) {
+  var input = new Channel();
+  var inputPort = new Port(input);
+  Process.spawnDetached(() {
+    var channel = new Channel();
+    inputPort.send(new Port(channel));
+    ForeignMemory memory = channel.receive();
+    Expect.equals(16, memory.length);
+    for (int i = 0; i < 16; i++) Expect.equals(i, memory.getUint8(i));
+    memory.setUint8(0, 42);
+    inputPort.transfer(memory);
+  });
+  Port output = input.receive();
+
+  var memory = finalized
+      ? new ForeignMemory.allocatedFinalized(16)
+      : new ForeignMemory.allocated(16);
+  for (int i = 0; i < 16; i++) memory.setUint8(i, i);
+  int address = memory.address;
+  output.transfer(memory);
+  Expect.equals(0, memory.length);
+  Expect.equals(0, memory.address);
+  Expect.throws(() => memory.getUint8(0), (e) => e is IndexError);
+
+  ForeignMemory result = input.receive();
+  Expect.equals(address, result.address);
+  Expect.equals(42, result.getUint8(0));
+  result.free();
+}
+
+testTransferToSelf() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  var memory = new ForeignMemory.allocatedFinalized(8);
+  memory.setUint64(0, 1234);
+  port.transfer(memory);
+  ForeignMemory result = channel.receive();
+  Expect.equals(1234, result.getUint64(0));
+}
+
+testTransferErrors() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  Expect.throws(() => port.transfer(42), (e) => e is ArgumentError);
+  Expect.throws(() => port.transfer(new List(1)), (e) => e is ArgumentError);
+}
@@ -0,0 +1,28 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+
+import 'package:expect/expect.dart';
+
+import 'utils.dart';
+
+// Echoes the requests of program_channel_sender.dart, which runs as another
+// program.
+main() {
+  var requests =
+      new ProgramChannel.open(REQUEST_CHANNEL, capacity: CHANNEL_CAPACITY);
+  var replies =
+      new ProgramChannel.open(REPLY_CHANNEL, capacity: CHANNEL_CAPACITY);
+
+  for (int i = 0; i < CHANNEL_MESSAGES; i++) {
+    var message = requests.receive();
+    Expect.listEquals(channelMessage(i), message);
+    // Sent straight from the foreign memory of the received bytes.
+    replies.send(message);
+  }
+
+  requests.close();
+  replies.close();
+}
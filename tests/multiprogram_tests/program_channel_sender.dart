@@ -0,0 +1,36 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+
+import 'package:expect/expect.dart';
+
+import 'utils.dart';
+
+// Sends requests to program_channel_receiver.dart, which runs as another
+// program, and checks that it echoes them.
+main() {
+  // Keep both channels open until all replies have arrived, so they are not
+  // deleted while the other program has not opened them yet.
+  var requests =
+      new ProgramChannel.open(REQUEST_CHANNEL, capacity: CHANNEL_CAPACITY);
+  var replies =
+      new ProgramChannel.open(REPLY_CHANNEL, capacity: CHANNEL_CAPACITY);
+
+  Process.spawnDetached(() {
+    var sender =
+        new ProgramChannel.open(REQUEST_CHANNEL, capacity: CHANNEL_CAPACITY);
+    for (int i = 0; i < CHANNEL_MESSAGES; i++) {
+      sender.send(channelMessage(i));
+    }
+    sender.close();
+  });
+
+  for (int i = 0; i < CHANNEL_MESSAGES; i++) {
+    Expect.listEquals(channelMessage(i), replies.receive());
+  }
+
+  requests.close();
+  replies.close();
+}
@@ -4,8 +4,24 @@
 
 library multiprogram_tests.utils;
 
+import 'dart:typed_data';
+
 import 'package:expect/expect.dart';
 
+// The program channels between program_channel_sender.dart and
+// program_channel_receiver.dart. They are small, so senders regularly wait
+// for the other program to make room.
+const String REQUEST_CHANNEL = 'multiprogram_requests';
+const String REPLY_CHANNEL = 'multiprogram_replies';
+const int CHANNEL_CAPACITY = 256;
+const int CHANNEL_MESSAGES = 1000;
+
+Uint8List channelMessage(int i) {
+  var message = new Uint8List(i % 100 + 1);
+  for (int j = 0; j < message.length; j++) message[j] = (i + j) & 0xff;
+  return message;
+}
+
 class Point {
   final double x;
   final double y;
@@ -0,0 +1,195 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+import 'dart:dartino.os';
+import 'dart:typed_data';
+
+import 'package:expect/expect.dart';
+import 'package:os/os.dart' as os;
+
+const int ROUNDS = 1000;
+
+void main() {
+  testWaitReady();
+  testWaitMessage();
+  testMarkReady();
+  testUnregisterThenClose();
+  testPingPong();
+}
+
+bool isStateError(e) => e is StateError;
+
+// Returns two connected non-blocking sockets.
+List<int> connectedPair() {
+  var address = os.sys.lookup("127.0.0.1");
+  int server = os.sys.socket(os.sys.AF_INET, os.sys.SOCK_STREAM, 0);
+  Expect.notEquals(-1, os.sys.bind(server, address, 0));
+  Expect.notEquals(-1, os.sys.listen(server));
+  int client = os.sys.socket(os.sys.AF_INET, os.sys.SOCK_STREAM, 0);
+  Expect.notEquals(-1, os.sys.connect(client, address, os.sys.port(server)));
+  int accepted = os.sys.accept(server);
+  Expect.notEquals(-1, accepted);
+  os.sys.close(server);
+  os.sys.setBlocking(client, false);
+  os.sys.setBlocking(accepted, false);
+  return [client, accepted];
+}
+
+// Waits like the socket package does. A message of 0 means the events were
+// taken while [EventRegistration.wait] ran, so it has to be called again.
+int waitFor(EventRegistration registration, Channel channel, int mask) {
+  while (true) {
+    int events = registration.wait(mask);
+    if (events == 0) events = channel.receive();
+    if (events != 0) return events;
+  }
+}
+
+// Checks that the event handler has not sent any message to [port].
+void expectNoMessage(Channel channel, Port port) {
+  port.send(-1);
+  Expect.equals(-1, channel.receive());
+}
+
+void writeByte(int fd, int value) {
+  var buffer = new Uint8List(1)..[0] = value;
+  Expect.equals(1, os.sys.write(fd, buffer.buffer, 0, 1));
+}
+
+int readByte(int fd, EventRegistration registration, Channel channel) {
+  var buffer = new Uint8List(1);
+  while (true) {
+    int read = os.sys.read(fd, buffer.buffer, 0, 1);
+    if (read == 1) return buffer[0];
+    Expect.equals(-1, read);
+    Expect.equals(os.errnos.EAGAIN, os.sys.errno());
+    Expect.equals(READ_EVENT, waitFor(registration, channel, READ_EVENT));
+  }
+}
+
+void testWaitReady() {
+  var fds = connectedPair();
+  var channel = new Channel();
+  var port = new Port(channel);
+  var registration = eventHandler.register(fds[0], port);
+
+  // A connected socket is writable right away. Once the event handler has
+  // seen that, waiting returns the event without sending a message.
+  sleep(100);
+  Expect.equals(WRITE_EVENT, registration.wait(WRITE_EVENT));
+  expectNoMessage(channel, port);
+
+  registration.unregister();
+  os.sys.close(fds[0]);
+  os.sys.close(fds[1]);
+}
+
+void testWaitMessage() {
+  var fds = connectedPair();
+  var channel = new Channel();
+  var port = new Port(channel);
+  var registration = eventHandler.register(fds[0], port);
+
+  // Nothing has been received yet, so the event is sent once it happens.
+  Expect.equals(0, registration.wait(READ_EVENT));
+  writeByte(fds[1], 42);
+  int events = channel.receive();
+  if (events == 0) events = waitFor(registration, channel, READ_EVENT);
+  Expect.equals(READ_EVENT, events);
+  Expect.equals(42, readByte(fds[0], registration, channel));
+
+  registration.unregister();
+  os.sys.close(fds[0]);
+  os.sys.close(fds[1]);
+}
+
+void testMarkReady() {
+  var fds = connectedPair();
+  var channel = new Channel();
+  var port = new Port(channel);
+  var registration = eventHandler.register(fds[0], port);
+  sleep(100);
+  Expect.equals(WRITE_EVENT, registration.wait(WRITE_EVENT));
+
+  // Marked events are pending, even though the socket did not report them,
+  // and waiting only takes the requested ones.
+  registration.markReady(READ_EVENT | WRITE_EVENT);
+  Expect.equals(WRITE_EVENT, registration.wait(WRITE_EVENT));
+  Expect.equals(READ_EVENT, registration.wait(READ_EVENT));
+  registration.markReady(READ_EVENT);
+  Expect.equals(READ_EVENT, registration.wait(READ_EVENT | WRITE_EVENT));
+  expectNoMessage(channel, port);
+
+  registration.unregister();
+  os.sys.close(fds[0]);
+  os.sys.close(fds[1]);
+}
+
+void testUnregisterThenClose() {
+  var fds = connectedPair();
+  var channel = new Channel();
+  var port = new Port(channel);
+  var registration = eventHandler.register(fds[0], port);
+  registration.unregister();
+
+  // The handle is dead, and using it does not reach the registration.
+  Expect.throws(() => registration.wait(READ_EVENT), isStateError);
+  Expect.throws(() => registration.markReady(READ_EVENT), isStateError);
+  Expect.throws(() => registration.unregister(), isStateError);
+
+  // Events are no longer sent to the port.
+  writeByte(fds[1], 1);
+  sleep(100);
+  expectNoMessage(channel, port);
+
+  // The descriptor can be registered again.
+  registration = eventHandler.register(fds[0], port);
+  Expect.equals(READ_EVENT, waitFor(registration, channel, READ_EVENT));
+  Expect.equals(1, readByte(fds[0], registration, channel));
+  registration.unregister();
+  Expect.equals(0, os.sys.close(fds[0]));
+
+  // A new descriptor can reuse the closed one's number.
+  var pair = connectedPair();
+  registration = eventHandler.register(pair[0], port);
+  writeByte(pair[1], 2);
+  Expect.equals(2, readByte(pair[0], registration, channel));
+  registration.unregister();
+  os.sys.close(pair[0]);
+  os.sys.close(pair[1]);
+  os.sys.close(fds[1]);
+}
+
+void echo(int fd, Port done) {
+  var channel = new Channel();
+  var registration = eventHandler.register(fd, new Port(channel));
+  for (int i = 0; i < ROUNDS; i++) {
+    writeByte(fd, readByte(fd, registration, channel));
+  }
+  registration.unregister();
+  done.send(null);
+}
+
+void testPingPong() {
+  var fds = connectedPair();
+  int peer = fds[1];
+  var done = new Channel();
+  var donePort = new Port(done);
+  Process.spawnDetached(() => echo(peer, donePort));
+
+  // Both sides wait for every byte, so a lost wakeup, e.g. when the events
+  // are taken while the event handler is sending them, hangs the test.
+  var channel = new Channel();
+  var registration = eventHandler.register(fds[0], new Port(channel));
+  for (int i = 0; i < ROUNDS; i++) {
+    writeByte(fds[0], i & 0xFF);
+    Expect.equals(i & 0xFF, readByte(fds[0], registration, channel));
+  }
+  done.receive();
+
+  registration.unregister();
+  os.sys.close(fds[0]);
+  os.sys.close(fds[1]);
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+import 'dart:dartino.os';
+
+import 'package:expect/expect.dart';
+
+const int LOOPBACK = 0x7f000001;
+
+void main() {
+  testNumeric();
+  testLocalhost();
+  testUnknownHost();
+  testConcurrentLookups();
+}
+
+void testNumeric() {
+  Expect.equals(LOOPBACK, HostResolver.lookupIPv4('127.0.0.1'));
+  Expect.equals(0x0a000203, HostResolver.lookupIPv4('10.0.2.3'));
+}
+
+void testLocalhost() {
+  // Resolved from /etc/hosts, so no network is needed. The second lookup
+  // is answered from the cache.
+  Expect.equals(LOOPBACK, HostResolver.lookupIPv4('localhost'));
+  Expect.equals(LOOPBACK, HostResolver.lookupIPv4('localhost'));
+}
+
+void testUnknownHost() {
+  // The .invalid top-level domain never resolves.
+  Expect.isTrue(HostResolver.lookupIPv4('dartino.invalid') < 0);
+  Expect.isTrue(HostResolver.lookupIPv4('dartino.invalid') < 0);
+  Expect.throws(() => HostResolver.lookupIPv4(42), (e) => e is ArgumentError);
+}
+
+void testConcurrentLookups() {
+  const int COUNT = 8;
+  var channel = new Channel();
+  var port = new Port(channel);
+  for (int i = 0; i < COUNT; i++) {
+    Process.spawnDetached(() {
+      port.send(HostResolver.lookupIPv4('127.0.0.${i + 1}'));
+    });
+  }
+  var results = new Set<int>();
+  for (int i = 0; i < COUNT; i++) results.add(channel.receive());
+  for (int i = 0; i < COUNT; i++) {
+    Expect.isTrue(results.contains(LOOPBACK + i));
+  }
+}
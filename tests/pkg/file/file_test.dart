@@ -11,6 +11,8 @@ void main() {
   testOpen();
   testReadWrite();
   testSeek();
+  testReadWriteAsync();
+  testMap();
 }
 
 bool isFileException(e) => e is FileException;
@@ -66,3 +68,58 @@ void testSeek() {
   file.close();
   File.delete(file.path);
 }
+
+void testReadWriteAsync() {
+  var file = new File.temporary("/tmp/file_async_test");
+
+  var data = new Uint8List(1024);
+  for (int i = 0; i < data.length; i++) data[i] = i & 0xff;
+  file.writeAsync(data.buffer);
+  file.flush();
+  Expect.equals(1024, file.position);
+  Expect.equals(1024, file.length);
+  Expect.equals(0, file.readAsync(16).lengthInBytes);
+
+  file.position = 0;
+  var list = new Uint8List.view(file.readAsync(2048));
+  Expect.equals(1024, list.length);
+  for (int i = 0; i < list.length; i++) Expect.equals(i & 0xff, list[i]);
+
+  file.close();
+  File.delete(file.path);
+}
+
+void testMap() {
+  var file = new File.temporary("/tmp/file_map_test");
+  var data = new Uint8List(4096);
+  for (int i = 0; i < data.length; i++) data[i] = i & 0xFF;
+  file.write(data.buffer);
+
+  var mapped = file.map();
+  Expect.equals(4096, mapped.length);
+  Expect.isFalse(mapped.isWritable);
+  var list = mapped.asUint8List();
+  for (int i = 0; i < list.length; i++) Expect.equals(i & 0xFF, list[i]);
+  Expect.equals(0x03020100,
+                mapped.asByteData().getUint32(0, Endianness.HOST_ENDIAN));
+  Expect.equals(16, new Uint8List.view(mapped.buffer, 16, 8)[0]);
+  Expect.throws(() => list[0] = 1, (e) => e is UnsupportedError);
+  Expect.throws(() => list[4096], (e) => e is RangeError);
+  mapped.close();
+  Expect.isFalse(mapped.isOpen);
+
+  // Writes to a writable mapping reach the file.
+  mapped = file.map(writable: true);
+  mapped.asUint8List()[1] = 42;
+  mapped.close();
+  file.position = 0;
+  Expect.equals(42, new Uint8List.view(file.read(2))[1]);
+
+  Expect.equals(0, file.map(offset: 4096).length);
+  // Ranges past the end of the file are rejected instead of being mapped.
+  Expect.throws(() => file.map(length: 8192), (e) => e is RangeError);
+  Expect.throws(() => file.map(offset: 8192), (e) => e is RangeError);
+
+  file.close();
+  File.delete(file.path);
+}
@@ -2,9 +2,11 @@
 // for details. All rights reserved. Use of this source code is governed by a
 // BSD-style license that can be found in the LICENSE.md file.
 
+import 'dart:dartino';
 import 'dart:typed_data';
 
 import 'package:expect/expect.dart';
+import 'package:file/file.dart';
 import 'package:os/os.dart' as os;
 import 'package:socket/socket.dart';
 
@@ -18,6 +20,12 @@ void main() {
   testLargeChunk();
   testShutdown();
   testFailingBind();
+  testBuffered();
+  testBufferedQueued();
+  testPersistent();
+  testPersistentLargeChunk();
+  testSendFile(false);
+  testSendFile(true);
 }
 
 void testFailingBind() {
@@ -199,3 +207,112 @@ void testShutdown() {
   socket.close();
   server.close();
 }
+
+void testBuffered() {
+  var server = new ServerSocket("127.0.0.1", 0, buffered: true);
+  var socket = new Socket.connect("127.0.0.1", server.port, buffered: true);
+  server.spawnAccept(largeChunkClient);
+
+  // Gather the chunk from more buffers than fit in a single write.
+  var buffers = [];
+  for (int i = 0; i < LARGE_CHUNK_SIZE ~/ CHUNK_SIZE; i++) {
+    buffers.add(createBuffer(CHUNK_SIZE));
+  }
+  socket.writeAll(buffers);
+  validateBuffer(socket.read(LARGE_CHUNK_SIZE), LARGE_CHUNK_SIZE);
+  Expect.equals(0, socket.available);
+  Expect.equals(null, socket.readNext());
+
+  socket.close();
+  server.close();
+}
+
+// The default capacity of the ring of a buffered socket.
+const RING_SIZE = 64 * 1024;
+
+void queuedClient(Socket client) {
+  client.write(createBuffer(3 * RING_SIZE));
+  // Keep the socket open, so no close event wakes up the reader.
+  validateBuffer(client.read(1), 1);
+  client.close();
+}
+
+void testBufferedQueued() {
+  var server = new ServerSocket("127.0.0.1", 0);
+  var socket = new Socket.connect("127.0.0.1", server.port, buffered: true);
+  server.spawnAccept(queuedClient);
+
+  // Let all the data arrive before the first read, so the socket reports
+  // no more events while the ring is refilled.
+  sleep(200);
+  validateBuffer(socket.read(3 * RING_SIZE), 3 * RING_SIZE);
+  socket.write(createBuffer(1));
+  Expect.equals(null, socket.read(1));
+
+  socket.close();
+  server.close();
+}
+
+void testPersistent() {
+  var server = new ServerSocket("127.0.0.1", 0, persistent: true);
+  // Closing unregisters the sockets before their descriptors are closed, so
+  // the next round can reuse them.
+  for (int i = 0; i < 2; i++) {
+    var socket = new Socket.connect("127.0.0.1", server.port,
+                                    persistent: true);
+    var client = server.accept();
+
+    socket.write(createBuffer(CHUNK_SIZE));
+    validateBuffer(client.read(CHUNK_SIZE), CHUNK_SIZE);
+    client.write(createBuffer(CHUNK_SIZE));
+    validateBuffer(socket.read(CHUNK_SIZE), CHUNK_SIZE);
+    Expect.equals(0, socket.available);
+    Expect.equals(0, client.available);
+
+    client.close();
+    Expect.equals(null, socket.read(1));
+    socket.close();
+  }
+  server.close();
+}
+
+void testPersistentLargeChunk() {
+  var server = new ServerSocket("127.0.0.1", 0, persistent: true);
+  var socket = new Socket.connect("127.0.0.1", server.port, persistent: true);
+  server.spawnAccept(largeChunkClient);
+
+  // The chunk does not fit in the socket buffers, so both sides wait for
+  // the other to read.
+  socket.write(createBuffer(LARGE_CHUNK_SIZE));
+  validateBuffer(socket.read(LARGE_CHUNK_SIZE), LARGE_CHUNK_SIZE);
+  Expect.equals(0, socket.available);
+
+  socket.close();
+  server.close();
+}
+
+void sendFileClient(Socket client) {
+  validateBuffer(client.read(LARGE_CHUNK_SIZE), LARGE_CHUNK_SIZE);
+  client.close();
+}
+
+void testSendFile(bool persistent) {
+  var file = new File.temporary("/tmp/socket_send_file_test");
+  file.write(createBuffer(CHUNK_SIZE));
+  file.write(createBuffer(LARGE_CHUNK_SIZE));
+
+  var server = new ServerSocket("127.0.0.1", 0);
+  var socket = new Socket.connect("127.0.0.1", server.port,
+                                  persistent: persistent);
+  server.spawnAccept(sendFileClient);
+
+  // The range ends past the end of the file.
+  Expect.equals(LARGE_CHUNK_SIZE,
+                socket.sendFile(file.fd, CHUNK_SIZE, 2 * LARGE_CHUNK_SIZE));
+  Expect.equals(null, socket.read(1));
+
+  socket.close();
+  server.close();
+  file.close();
+  File.delete(file.path);
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+
+import 'package:expect/expect.dart';
+
+const int MESSAGES = 1000;
+
+main() {
+  testQueueLength();
+  testFail();
+  testDropOldest();
+  testBlock();
+}
+
+testQueueLength() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  Expect.equals(0, port.capacity);
+  Expect.equals(0, port.queueLength);
+  port.send(1);
+  port.send(2);
+  Expect.equals(2, port.queueLength);
+  Expect.equals(1, channel.receive());
+  Expect.equals(0, port.queueLength);
+  Expect.equals(2, channel.receive());
+  Expect.throws(() => new Port.bounded(channel, 0), (e) => e is ArgumentError);
+}
+
+testFail() {
+  var channel = new Channel();
+  var port = new Port.bounded(channel, 2, overflow: PortOverflow.fail);
+  Expect.equals(2, port.capacity);
+  port.send(1);
+  port.send(2);
+  Expect.throws(() => port.send(3), (e) => e is StateError);
+  Expect.equals(1, channel.receive());
+  Expect.equals(2, channel.receive());
+  port.send(3);
+  Expect.equals(3, channel.receive());
+}
+
+testDropOldest() {
+  var channel = new Channel();
+  var port = new Port.bounded(channel, 2, overflow: PortOverflow.dropOldest);
+  for (int i = 0; i < 5; i++) port.send(i);
+  Expect.equals(3, channel.receive());
+  Expect.equals(4, channel.receive());
+  Expect.equals(0, port.queueLength);
+}
+
+testBlock() {
+  var channel = new Channel();
+  var port = new Port.bounded(channel, 4);
+  Process.spawnDetached(() {
+    for (int i = 0; i < MESSAGES; i++) port.send(i);
+  });
+  for (int i = 0; i < MESSAGES; i++) {
+    Expect.equals(i, channel.receive());
+  }
+}
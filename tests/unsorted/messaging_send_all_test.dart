@@ -0,0 +1,49 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+
+import 'package:expect/expect.dart';
+
+const int MESSAGES = 1000;
+
+main() {
+  testSendAllToSelf();
+  testSendAllToOtherProcess();
+  testSendAllMutable();
+}
+
+testSendAllToSelf() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  port.sendAll([]);
+  port.sendAll([1, 2, 3]);
+  port.sendAll(const ["a", "b"]);
+  for (var expected in [1, 2, 3, "a", "b"]) {
+    Expect.equals(expected, channel.receive());
+  }
+}
+
+testSendAllToOtherProcess() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  Process.spawnDetached(() {
+    var messages = new List.generate(MESSAGES, (i) => i);
+    port.sendAll(messages);
+    port.send(null);
+  });
+  for (int i = 0; i < MESSAGES; i++) {
+    Expect.equals(i, channel.receive());
+  }
+  Expect.isNull(channel.receive());
+}
+
+testSendAllMutable() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  Expect.throws(() => port.sendAll([1, new List(1)]),
+                (e) => e is ArgumentError);
+  port.send(null);
+  Expect.isNull(channel.receive());
+}
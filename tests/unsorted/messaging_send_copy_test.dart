@@ -0,0 +1,103 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+import 'dart:dartino.ffi';
+
+import 'package:expect/expect.dart';
+
+class Node {
+  var value;
+  Node next;
+  Node(this.value);
+}
+
+main() {
+  testCopyToSelf();
+  testCopyToOtherProcess();
+  testCycles();
+  testUncopyable();
+  testLargeGraph();
+}
+
+testCopyToSelf() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  var list = [1, "two", [3, 4], {"five": 5}];
+  port.sendCopy(list);
+  var copy = channel.receive();
+  Expect.isFalse(identical(list, copy));
+  Expect.listEquals([1, "two"], copy.sublist(0, 2));
+  Expect.listEquals([3, 4], copy[2]);
+  Expect.equals(5, copy[3]["five"]);
+
+  // The copy is private to the receiver.
+  copy[2][0] = 42;
+  Expect.equals(3, list[2][0]);
+
+  port.sendCopy(7);
+  Expect.equals(7, channel.receive());
+}
+
+testCopyToOtherProcess() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  Process.spawnDetached(() {
+    var map = new Map();
+    for (int i = 0; i < 100; i++) map[i] = [i, "$i"];
+    port.sendCopy(map);
+  });
+  Map map = channel.receive();
+  Expect.equals(100, map.length);
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(i, map[i][0]);
+    Expect.equals("$i", map[i][1]);
+  }
+}
+
+testCycles() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  var first = new Node(1);
+  var second = new Node(2);
+  first.next = second;
+  second.next = first;
+  port.sendCopy([first, second]);
+  List copy = channel.receive();
+  Node a = copy[0];
+  Node b = copy[1];
+  Expect.isFalse(identical(a, first));
+  Expect.identical(b, a.next);
+  Expect.identical(a, b.next);
+  Expect.equals(1, a.value);
+  Expect.equals(2, b.value);
+}
+
+testUncopyable() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  var memory = new ForeignMemory.allocatedFinalized(4);
+  Expect.throws(() => port.sendCopy([memory]), (e) => e is ArgumentError);
+  port.send(null);
+  Expect.isNull(channel.receive());
+}
+
+// The copy is larger than new-space and has to be allocated in old-space.
+testLargeGraph() {
+  var channel = new Channel();
+  var port = new Port(channel);
+  Node head;
+  for (int i = 0; i < 10000; i++) {
+    Node node = new Node([i]);
+    node.next = head;
+    head = node;
+  }
+  port.sendCopy(head);
+  Node copy = channel.receive();
+  for (int i = 9999; i >= 0; i--) {
+    Expect.equals(i, copy.value[0]);
+    copy = copy.next;
+  }
+  Expect.isNull(copy);
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2016, the Dartino project authors. Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE.md file.
+
+import 'dart:dartino';
+import 'dart:typed_data';
+
+import 'package:expect/expect.dart';
+
+const int MESSAGES = 1000;
+
+main() {
+  testSendToSelf();
+  testSendFromOtherProcess();
+  testWrapAround();
+  testInvalidMessages();
+  testTypedData();
+  testSingleReceiver();
+}
+
+testSendToSelf() {
+  var channel = new ProgramChannel.open("self");
+  channel.send([]);
+  channel.send([1, 2, 255]);
+  Expect.listEquals([], channel.receive());
+  Expect.listEquals([1, 2, 255], channel.receive());
+  channel.close();
+  Expect.throws(() => channel.receive(), (e) => e is StateError);
+}
+
+testSendFromOtherProcess() {
+  var channel = new ProgramChannel.open("other", capacity: 256);
+  Process.spawnDetached(() {
+    var sender = new ProgramChannel.open("other");
+    for (int i = 0; i < MESSAGES; i++) {
+      sender.send([i & 0xff, i >> 8]);
+    }
+    sender.close();
+  });
+  for (int i = 0; i < MESSAGES; i++) {
+    Expect.listEquals([i & 0xff, i >> 8], channel.receive());
+  }
+  channel.close();
+}
+
+testWrapAround() {
+  var channel = new ProgramChannel.open("wrap", capacity: 256);
+  for (int i = 0; i < 100; i++) {
+    var message = new List.filled(i % 100, i);
+    channel.send(message);
+    Expect.listEquals(message, channel.receive());
+  }
+  channel.close();
+}
+
+testInvalidMessages() {
+  var channel = new ProgramChannel.open("invalid", capacity: 256);
+  Expect.throws(() => channel.send([256]), (e) => e is ArgumentError);
+  Expect.throws(() => channel.send(["a"]), (e) => e is ArgumentError);
+  Expect.throws(() => channel.send(new List.filled(1000, 0)),
+                (e) => e is RangeError);
+  channel.close();
+}
+
+testTypedData() {
+  var channel = new ProgramChannel.open("typed", capacity: 256);
+  var bytes = new Uint8List.fromList([0, 1, 2, 3, 4, 5, 6, 7]);
+  channel.send(bytes);
+  channel.send(new Uint8List.view(bytes.buffer, 2, 3));
+  channel.send(bytes.buffer);
+  var received = channel.receive();
+  Expect.isTrue(received is Uint8List);
+  Expect.listEquals(bytes, received);
+  Expect.listEquals([2, 3, 4], channel.receive());
+  Expect.listEquals(bytes, channel.receive());
+  channel.close();
+}
+
+testSingleReceiver() {
+  var channel = new ProgramChannel.open("single", capacity: 256);
+  var received;
+  var fiber = Fiber.fork(() { received = channel.receive(); });
+  Fiber.yield();
+  Expect.throws(() => channel.receive(), (e) => e is StateError);
+  channel.send([42]);
+  fiber.join();
+  Expect.listEquals([42], received);
+  channel.close();
+}